@@ -0,0 +1,236 @@
+// ---------------------------------------------------------
+// File: Bitwise.cpp
+// Shifts, logical operations and bit queries on Integers.
+//
+// Author: agent <agent@local>
+// Last Modification: 2026-10-16
+//
+// Integers are stored as sign and magnitude but these
+// operations behave as on two's complement. The two's
+// complement limbs of a negative x are ~(|x| - 1), so they
+// are produced on the fly in one pass: the subtraction of one
+// borrows through the low zero limbs only. A negative result
+// is turned back into a magnitude the same way, as ~r + 1.
+// ---------------------------------------------------------
+
+#include "Limb.h"
+#include <algorithm>  // for std::copy, std::max
+
+using limb::Limb;
+
+// ---------------------------------------------------------
+// operator<<, operator>>
+// Whole limbs move by offset, the remaining bits through the
+// lshift/rshift kernels. A negative value shifted right gains
+// one in magnitude if any bit shifted out was set, which
+// rounds the quotient down instead of toward zero.
+// ---------------------------------------------------------
+Integer Integer::operator<<(std::size_t n) const
+{
+  if (isZero() || n == 0)
+    return *this;
+
+  std::size_t words = n / 64, an = limbs.size();
+  unsigned bits = n % 64;
+  Integer r;
+  r.limbs.resize(an + words + 1);
+  if (bits)
+    r.limbs[an + words] = limb::lshift(r.limbs.data() + words,
+                                       limbs.data(), an, bits);
+  else
+    std::copy(limbs.begin(), limbs.end(), r.limbs.begin() + words);
+  r.sign = sign;
+  r.normalize();
+  return r;
+}
+
+Integer Integer::operator>>(std::size_t n) const
+{
+  std::size_t words = n / 64, an = limbs.size();
+  unsigned bits = n % 64;
+  if (words >= an)
+    return sign ? Integer(-1) : Integer();
+  if (n == 0)
+    return *this;
+
+  bool dropped = false;
+  if (sign)
+  {
+    for (std::size_t i = 0; i < words && !dropped; ++i)
+      dropped = limbs[i] != 0;
+    if (bits && (limbs[words] << (64 - bits)) != 0)
+      dropped = true;
+  }
+
+  Integer r;
+  std::size_t rn = an - words;
+  r.limbs.resize(rn);
+  if (bits)
+    limb::rshift(r.limbs.data(), limbs.data() + words, rn, bits);
+  else
+    std::copy(limbs.begin() + words, limbs.end(), r.limbs.begin());
+  if (dropped && limb::add_1(r.limbs.data(), r.limbs.data(), rn, 1))
+    r.limbs.push_back(1);
+  r.sign = sign;
+  r.normalize();
+  return r;
+}
+
+// ---------------------------------------------------------
+// bitwise(a,b,op)
+// Runs over max(an,bn) + 1 limbs, the last one holding only
+// sign bits, so that a negative result such as -B^n always
+// has room for its magnitude.
+// ---------------------------------------------------------
+namespace
+{
+  Limb apply(char op, Limb x, Limb y)
+  {
+    switch (op)
+    {
+    case '&':
+      return x & y;
+    case '|':
+      return x | y;
+    default:
+      return x ^ y;
+    }
+  }
+
+  // Limb i of the two's-complement form of a sign and
+  // magnitude; borrow starts out as the sign.
+  Limb twos(bool negative, const LimbVector &mag, std::size_t i,
+            bool &borrow)
+  {
+    Limb x = i < mag.size() ? mag[i] : 0;
+    if (!negative)
+      return x;
+    Limb v = x - borrow;
+    borrow = borrow && x == 0;
+    return ~v;
+  }
+}
+
+Integer Integer::bitwise(const Integer &a, const Integer &b, char op)
+{
+  bool negative = apply(op, a.sign, b.sign) & 1;
+  std::size_t n = std::max(a.limbs.size(), b.limbs.size()) + 1;
+
+  Integer r;
+  r.limbs.resize(n);
+  bool borrowA = a.sign, borrowB = b.sign, carry = negative;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    Limb z = apply(op, twos(a.sign, a.limbs, i, borrowA),
+                   twos(b.sign, b.limbs, i, borrowB));
+    if (negative)
+    {
+      z = ~z + carry;
+      carry = carry && z == 0;
+    }
+    r.limbs[i] = z;
+  }
+  r.sign = negative;
+  r.normalize();
+  return r;
+}
+
+Integer Integer::operator&(const Integer &rhs) const
+{ return bitwise(*this, rhs, '&'); }
+
+Integer Integer::operator|(const Integer &rhs) const
+{ return bitwise(*this, rhs, '|'); }
+
+Integer Integer::operator^(const Integer &rhs) const
+{ return bitwise(*this, rhs, '^'); }
+
+Integer Integer::operator~() const
+{
+  Integer r = -*this;
+  r -= Integer(1);
+  return r;
+}
+
+// ---------------------------------------------------------
+// Compound assignment
+// ---------------------------------------------------------
+Integer &Integer::operator<<=(std::size_t n)
+{
+  *this = *this << n;
+  return *this;
+}
+
+Integer &Integer::operator>>=(std::size_t n)
+{
+  *this = *this >> n;
+  return *this;
+}
+
+Integer &Integer::operator&=(const Integer &rhs)
+{
+  *this = *this & rhs;
+  return *this;
+}
+
+Integer &Integer::operator|=(const Integer &rhs)
+{
+  *this = *this | rhs;
+  return *this;
+}
+
+Integer &Integer::operator^=(const Integer &rhs)
+{
+  *this = *this ^ rhs;
+  return *this;
+}
+
+// ---------------------------------------------------------
+// Bit queries
+// ---------------------------------------------------------
+std::size_t Integer::bitLength() const
+{
+  if (isZero())
+    return 0;
+  return 64*limbs.size() - __builtin_clzll(limbs.back());
+}
+
+Limb Integer::topBits() const
+{
+  if (isZero())
+    return 0;
+  std::size_t n = limbs.size();
+  unsigned z = __builtin_clzll(limbs[n-1]);
+  Limb top = limbs[n-1] << z;
+  if (z && n > 1)
+    top |= limbs[n-2] >> (64 - z);
+  return top;
+}
+
+std::size_t Integer::popCount() const
+{
+  std::size_t count = 0;
+  for (Limb x : limbs)
+    count += __builtin_popcountll(x);
+  return count;
+}
+
+// ---------------------------------------------------------
+// testBit(n)
+// For a negative value, limb n/64 of |x| - 1 differs from that
+// of |x| only if every limb below it is zero.
+// ---------------------------------------------------------
+bool Integer::testBit(std::size_t n) const
+{
+  std::size_t i = n / 64;
+  if (i >= limbs.size())
+    return sign;
+  Limb x = limbs[i];
+  if (sign)
+  {
+    bool lowZero = true;
+    for (std::size_t k = 0; k < i && lowZero; ++k)
+      lowZero = limbs[k] == 0;
+    x = ~(x - lowZero);
+  }
+  return (x >> (n % 64)) & 1;
+}
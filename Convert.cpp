@@ -0,0 +1,413 @@
+// ---------------------------------------------------------
+// File: Convert.cpp
+// Radix conversion between limb arrays and digit strings.
+//
+// Author: agent <agent@local>
+// Last Modification: 2026-10-16
+//
+// Power-of-two bases are converted by regrouping bits, in
+// linear time. Other bases work on chunks of k digits, where
+// b^k is the largest power of the base that fits a limb, and
+// switch to divide-and-conquer above a small size: printing
+// splits the number with divisions by b^(k*2^i), parsing joins
+// halves with multiplications by the same powers. The powers,
+// and for printing their precomputed reciprocals, are cached
+// per thread and base up to a fixed size, so repeated
+// conversions reuse them without pinning huge powers.
+// ---------------------------------------------------------
+
+#include "Limb.h"
+#include <algorithm>  // for std::copy, std::fill, std::min
+#include <map>
+#include <memory>     // for std::unique_ptr
+#include <vector>
+
+namespace limb
+{
+
+namespace
+{
+
+using Nat = LimbVector;
+
+// Below this many limbs conversions use the quadratic
+// chunk-at-a-time loops.
+const std::size_t BASECASE_LIMBS = 30;
+
+// From this many limbs on, the cached powers are divided by
+// with a precomputed Newton reciprocal (see Divisor), well
+// below the Newton threshold of one-off divisions: a power is
+// reused by every conversion of the same or a larger size.
+const std::size_t RECIPROCAL_LIMBS = 100;
+
+// Powers above this many limbs, and their reciprocals, are
+// dropped after each conversion rather than kept per thread
+// for its lifetime; rebuilding them costs a few
+// multiplications of that size, small next to the conversion.
+const std::size_t CACHED_LIMBS = 1 << 14;
+
+// log2(base) for power-of-two bases, 0 otherwise.
+unsigned bitsPerDigit(unsigned base)
+{
+  return (base & (base - 1)) == 0 ? __builtin_ctz(base) : 0;
+}
+
+// ---------------------------------------------------------
+// PowerTable
+// Powers b^(k*2^i) of one base, built by repeated squaring
+// on first use.
+// ---------------------------------------------------------
+class PowerTable
+{
+public:
+  explicit PowerTable(unsigned b)
+    : base(b), chunk(b), chunkDigits(1)
+  {
+    while (chunk <= ~Limb(0) / base)
+    {
+      chunk *= base;
+      ++chunkDigits;
+    }
+    powers.push_back(Nat{chunk});
+  }
+
+  unsigned base;
+  Limb chunk;              // b^k
+  std::size_t chunkDigits; // k
+
+  // Digits represented by power(i), i.e. k*2^i.
+  std::size_t digits(std::size_t i) const { return chunkDigits << i; }
+
+  // The table outlives any LimbArena the caller may have made
+  // current, so its entries always come from the pool.
+  const Nat &power(std::size_t i)
+  {
+    LimbAllocatorScope pool(LimbAllocator::pool());
+    while (powers.size() <= i)
+    {
+      const Nat &p = powers.back();
+      Nat sq(2 * p.size());
+      sqr(sq.data(), p.data(), p.size());
+      sq.resize(normalizedSize(sq.data(), sq.size()));
+      powers.push_back(std::move(sq));
+    }
+    return powers[i];
+  }
+
+  const Divisor &divisor(std::size_t i)
+  {
+    if (divisors.size() <= i)
+      divisors.resize(i + 1);
+    if (!divisors[i])
+    {
+      const Nat &p = power(i);
+      LimbAllocatorScope pool(LimbAllocator::pool());
+      divisors[i].reset(new Divisor(p.data(), p.size(),
+                                    p.size() >= RECIPROCAL_LIMBS));
+    }
+    return *divisors[i];
+  }
+
+  // Drops the powers of more than limbs limbs.
+  void release(std::size_t limbs)
+  {
+    std::size_t keep = 1;
+    while (keep < powers.size() && powers[keep].size() <= limbs)
+      ++keep;
+    powers.resize(keep);
+    if (divisors.size() > keep)
+      divisors.resize(keep);
+  }
+
+private:
+  std::vector<Nat> powers;
+  std::vector<std::unique_ptr<Divisor>> divisors;
+};
+
+PowerTable &powerTable(unsigned base)
+{
+  thread_local std::map<unsigned, PowerTable> tables;
+  auto it = tables.find(base);
+  if (it == tables.end())
+    it = tables.emplace(base, PowerTable(base)).first;
+  return it->second;
+}
+
+// ---------------------------------------------------------
+// Power-of-two bases
+// ---------------------------------------------------------
+std::size_t getStrBits(unsigned char *s, const Limb *a, std::size_t n,
+                       unsigned bits)
+{
+  std::size_t totalBits = 64 * n - __builtin_clzll(a[n-1]);
+  std::size_t len = (totalBits + bits - 1) / bits;
+  Limb mask = (Limb(1) << bits) - 1;
+  for (std::size_t j = 0; j < len; ++j)
+  {
+    // Digit j (from the least significant end) may straddle
+    // two limbs.
+    std::size_t pos = j * bits, i = pos / 64, off = pos % 64;
+    Limb digit = a[i] >> off;
+    if (off + bits > 64 && i + 1 < n)
+      digit |= a[i+1] << (64 - off);
+    s[len - 1 - j] = static_cast<unsigned char>(digit & mask);
+  }
+  return len;
+}
+
+std::size_t setStrBits(Limb *r, const unsigned char *s, std::size_t len,
+                       unsigned bits)
+{
+  std::size_t rn = (len * bits + 63) / 64;
+  std::fill(r, r + rn, 0);
+  for (std::size_t j = 0; j < len; ++j)
+  {
+    Limb digit = s[len - 1 - j];
+    std::size_t pos = j * bits, i = pos / 64, off = pos % 64;
+    r[i] |= digit << off;
+    if (off + bits > 64)
+      r[i+1] |= digit >> (64 - off);
+  }
+  return normalizedSize(r, rn);
+}
+
+// ---------------------------------------------------------
+// Chunk basecases
+// ---------------------------------------------------------
+
+// Writes the k digits of one chunk, least significant last.
+// The base is a template parameter for the common bases so
+// the divisions by it become multiplications.
+template <unsigned Base>
+void writeChunk(unsigned char *end, Limb chunk, std::size_t k)
+{
+  for (std::size_t j = 0; j < k; ++j)
+  {
+    *--end = static_cast<unsigned char>(chunk % Base);
+    chunk /= Base;
+  }
+}
+
+void writeChunk(unsigned char *end, Limb chunk, std::size_t k,
+                unsigned base)
+{
+  switch (base)
+  {
+  case 10:
+    writeChunk<10>(end, chunk, k);
+    break;
+  case 100:
+    writeChunk<100>(end, chunk, k);
+    break;
+  default:
+    for (std::size_t j = 0; j < k; ++j)
+    {
+      *--end = static_cast<unsigned char>(chunk % base);
+      chunk /= base;
+    }
+  }
+}
+
+// Writes exactly width digits of x (x < b^width), zero padded.
+void getStrBasecase(unsigned char *s, std::size_t width, Nat x,
+                    const PowerTable &t)
+{
+  std::size_t n = normalizedSize(x.data(), x.size());
+  std::size_t pos = width;
+  while (n > 0)
+  {
+    Limb chunk = divrem_1(x.data(), x.data(), n, t.chunk);
+    n = normalizedSize(x.data(), n);
+    std::size_t k = std::min(t.chunkDigits, pos);
+    writeChunk(s + pos, chunk, k, t.base);
+    pos -= k;
+  }
+  std::fill(s, s + pos, 0);
+}
+
+Nat setStrBasecase(const unsigned char *s, std::size_t len,
+                   const PowerTable &t)
+{
+  Nat r;
+  r.reserve(len / t.chunkDigits + 2);
+  std::size_t first = len % t.chunkDigits ? len % t.chunkDigits
+                                          : t.chunkDigits;
+  for (std::size_t i = 0; i < len;)
+  {
+    std::size_t k = i == 0 ? first : t.chunkDigits;
+    Limb chunk = 0, scale = 1;
+    for (std::size_t j = 0; j < k; ++j)
+    {
+      chunk = chunk * t.base + s[i + j];
+      scale *= t.base;
+    }
+    Limb carry = mul_1(r.data(), r.data(), r.size(), scale);
+    if (carry)
+      r.push_back(carry);
+    // On an empty r, add_1 hands the whole chunk back.
+    carry = add_1(r.data(), r.data(), r.size(), chunk);
+    if (carry)
+      r.push_back(carry);
+    i += k;
+  }
+  r.resize(normalizedSize(r.data(), r.size()));
+  return r;
+}
+
+// ---------------------------------------------------------
+// getStrRecursive(s,x,i,t)
+// Writes exactly 2*t.digits(i) digits of x to s, zero padded.
+// Preconditions: x < power(i)^2.
+// ---------------------------------------------------------
+void getStrRecursive(unsigned char *s, Nat x, std::size_t i,
+                     PowerTable &t)
+{
+  std::size_t width = 2 * t.digits(i);
+  std::size_t xn = normalizedSize(x.data(), x.size());
+  if (xn == 0)
+  {
+    std::fill(s, s + width, 0);
+    return;
+  }
+  if (i == 0 || xn < BASECASE_LIMBS)
+  {
+    x.resize(xn);
+    getStrBasecase(s, width, std::move(x), t);
+    return;
+  }
+
+  const Divisor &d = t.divisor(i);
+  std::size_t dn = d.size();
+  Nat q, r;
+  if (xn < dn)
+  {
+    r = std::move(x);
+  }
+  else
+  {
+    q.resize(xn - dn + 1);
+    r.resize(dn);
+    d.divrem(q.data(), r.data(), x.data(), xn);
+    x = Nat();
+  }
+  getStrRecursive(s, std::move(q), i - 1, t);
+  getStrRecursive(s + t.digits(i), std::move(r), i - 1, t);
+}
+
+// ---------------------------------------------------------
+// getStrTop(s,width,x,t)
+// Writes x to s[0..width), zero padded; x < b^width. Splits
+// off the low digits with the power of about half the limbs
+// of x, so no power larger than that is built or divided by.
+// ---------------------------------------------------------
+void getStrTop(unsigned char *s, std::size_t width, Nat x, PowerTable &t)
+{
+  std::size_t xn = normalizedSize(x.data(), x.size());
+  if (xn < BASECASE_LIMBS)
+  {
+    x.resize(xn);
+    getStrBasecase(s, width, std::move(x), t);
+    return;
+  }
+
+  // power(i) has more than xn/4 and at most about xn/2 limbs.
+  std::size_t i = 0;
+  while (4 * t.power(i).size() <= xn)
+    ++i;
+
+  const Divisor &d = t.divisor(i);
+  std::size_t dn = d.size();
+  Nat q(xn - dn + 1), r(dn);
+  d.divrem(q.data(), r.data(), x.data(), xn);
+  x = Nat();
+
+  // The remainder is below power(i) = power(i-1)^2.
+  std::size_t low = t.digits(i);
+  getStrTop(s, width - low, std::move(q), t);
+  getStrRecursive(s + width - low, std::move(r), i - 1, t);
+}
+
+// ---------------------------------------------------------
+// setStrRecursive(s,len,t)
+// Value of len digits: high part * b^(k*2^i) + low part,
+// with the low part the largest such power of at most half of
+// len, so the high part is at least as long.
+// ---------------------------------------------------------
+Nat setStrRecursive(const unsigned char *s, std::size_t len,
+                    PowerTable &t)
+{
+  if (len <= BASECASE_LIMBS * t.chunkDigits)
+    return setStrBasecase(s, len, t);
+
+  std::size_t i = 0;
+  while (2 * t.digits(i + 1) <= len)
+    ++i;
+  std::size_t lo = t.digits(i);
+
+  Nat high = setStrRecursive(s, len - lo, t);
+  Nat low = setStrRecursive(s + len - lo, lo, t);
+  const Nat &p = t.power(i);
+
+  Nat r(high.size() + p.size() + 1);
+  if (!high.empty())
+  {
+    if (high.size() >= p.size())
+      mul(r.data(), high.data(), high.size(), p.data(), p.size());
+    else
+      mul(r.data(), p.data(), p.size(), high.data(), high.size());
+  }
+  if (!low.empty())
+    add(r.data(), r.data(), r.size(), low.data(), low.size());
+  r.resize(normalizedSize(r.data(), r.size()));
+  return r;
+}
+
+} // namespace
+
+std::size_t get_str_size(std::size_t n, unsigned base)
+{
+  // floor(log2(base)) underestimates the bits per digit.
+  unsigned bits = 31 - __builtin_clz(base);
+  return 64 * n / bits + 1;
+}
+
+std::size_t get_str(unsigned char *s, const Limb *a, std::size_t n,
+                    unsigned base)
+{
+  if (unsigned bits = bitsPerDigit(base))
+    return getStrBits(s, a, n, bits);
+
+  std::size_t width = get_str_size(n, base);
+  std::vector<unsigned char> buffer(width);
+  PowerTable &t = powerTable(base);
+  getStrTop(buffer.data(), width, Nat(a, a + n), t);
+  t.release(CACHED_LIMBS);
+
+  std::size_t skip = 0;
+  while (skip + 1 < width && buffer[skip] == 0)
+    ++skip;
+  std::copy(buffer.begin() + skip, buffer.end(), s);
+  return width - skip;
+}
+
+std::size_t set_str_size(std::size_t len, unsigned base)
+{
+  // ceil(log2(base)) overestimates the bits per digit.
+  unsigned bits = 32 - __builtin_clz(base - 1);
+  return len * bits / 64 + 1;
+}
+
+std::size_t set_str(Limb *r, const unsigned char *s, std::size_t len,
+                    unsigned base)
+{
+  if (unsigned bits = bitsPerDigit(base))
+    return setStrBits(r, s, len, bits);
+
+  PowerTable &t = powerTable(base);
+  Nat x = setStrRecursive(s, len, t);
+  t.release(CACHED_LIMBS);
+  std::copy(x.begin(), x.end(), r);
+  return x.size();
+}
+
+} // namespace limb
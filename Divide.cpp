@@ -0,0 +1,490 @@
+// ---------------------------------------------------------
+// File: Divide.cpp
+// Division algorithms for limb arrays.
+//
+// Author: agent <agent@local>
+// Last Modification: 2026-10-16
+//
+// Single-limb divisors use a Moller-Granlund reciprocal.
+// Longer divisors are normalized (top bit set) and divided
+// with Knuth's Algorithm D, or, above the divide-and-conquer
+// threshold, with the recursive scheme of Burnikel and Ziegler
+// that reduces division to a few multiplications. Very large
+// divisions use a Newton reciprocal and Barrett's method, which
+// costs a small constant number of multiplications.
+// ---------------------------------------------------------
+
+#include "Limb.h"
+#include <algorithm>  // for std::copy, std::max
+
+namespace limb
+{
+
+namespace
+{
+
+// ---------------------------------------------------------
+// Reciprocal
+// Divides two-limb numbers by a normalized limb d using
+// v = floor((B^2-1)/d) - B (Moller & Granlund, 2011).
+// ---------------------------------------------------------
+struct Reciprocal
+{
+  Limb d;
+  Limb v;
+
+  explicit Reciprocal(Limb divisor)
+    : d(divisor),
+      v(static_cast<Limb>(
+          ((static_cast<DoubleLimb>(~divisor) << 64) | ~Limb(0)) / divisor))
+  {}
+
+  // Returns (u1:u0) / d and stores the remainder in r.
+  // Preconditions: u1 < d.
+  Limb divide(Limb u1, Limb u0, Limb &r) const
+  {
+    DoubleLimb p = static_cast<DoubleLimb>(v) * u1
+                   + ((static_cast<DoubleLimb>(u1 + 1) << 64) | u0);
+    Limb q1 = static_cast<Limb>(p >> 64);
+    Limb q0 = static_cast<Limb>(p);
+    r = u0 - q1 * d;
+    if (r > q0)
+    {
+      --q1;
+      r += d;
+    }
+    if (r >= d)
+    {
+      ++q1;
+      r -= d;
+    }
+    return q1;
+  }
+};
+
+unsigned leadingZeros(Limb x)
+{
+  return static_cast<unsigned>(__builtin_clzll(x));
+}
+
+// Divide-and-conquer threshold, clamped so recursion shrinks.
+std::size_t dcThreshold()
+{
+  return std::max<std::size_t>(
+    Integer::divideThresholds().divideAndConquer, 2);
+}
+
+// Newton threshold, clamped so the reciprocal recursion halts.
+std::size_t newtonThreshold()
+{
+  return std::max<std::size_t>(Integer::divideThresholds().newton, 8);
+}
+
+// ---------------------------------------------------------
+// schoolbookDivide(q,a,an,d,dn)
+// Knuth's Algorithm D. q[0..an-dn) receives the quotient and
+// a[0..dn) the remainder. Returns the top quotient limb (0/1).
+// Preconditions: an >= dn >= 1, d normalized.
+// ---------------------------------------------------------
+Limb schoolbookDivide(Limb *q, Limb *a, std::size_t an,
+                      const Limb *d, std::size_t dn)
+{
+  Limb *top = a + an - dn;
+  Limb qh = cmp(top, d, dn) >= 0;
+  if (qh)
+    sub_n(top, top, d, dn);
+
+  Limb d1 = d[dn-1];
+  Limb d0 = dn >= 2 ? d[dn-2] : 0;
+  Reciprocal rec(d1);
+
+  for (std::size_t j = an - dn; j-- > 0;)
+  {
+    Limb n2 = a[j+dn], n1 = a[j+dn-1];
+    Limb qhat, rhat;
+    bool rhatOverflow = false;
+    if (n2 >= d1)
+    {
+      // Only n2 == d1 is possible; clamp the estimate to B-1.
+      qhat = ~Limb(0);
+      rhat = n1 + d1;
+      rhatOverflow = rhat < n1;
+    }
+    else
+    {
+      qhat = rec.divide(n2, n1, rhat);
+    }
+
+    // Refine with the second divisor limb; at most two steps.
+    if (dn >= 2)
+    {
+      Limb n0 = a[j+dn-2];
+      while (!rhatOverflow
+             && static_cast<DoubleLimb>(qhat) * d0
+                > ((static_cast<DoubleLimb>(rhat) << 64) | n0))
+      {
+        --qhat;
+        rhat += d1;
+        rhatOverflow = rhat < d1;
+      }
+    }
+
+    Limb borrow = submul_1(a + j, d, dn, qhat);
+    Limb hi = a[j+dn];
+    a[j+dn] = hi - borrow;
+    if (hi < borrow)
+    {
+      // Estimate was one too large: add the divisor back.
+      --qhat;
+      a[j+dn] += add_n(a + j, a + j, d, dn);
+    }
+    q[j] = qhat;
+  }
+  return qh;
+}
+
+Limb divideBlock(Limb *q, Limb *a, const Limb *d, std::size_t n);
+
+// ---------------------------------------------------------
+// divide2by1(q,a,d,n)
+// Divides the 2n-limb a by the n-limb d recursively: two
+// half-size divisions, each followed by a multiply-and-
+// correct step. q[0..n) receives the quotient, a[0..n) the
+// remainder. Returns the top quotient limb (0/1).
+// Preconditions: d normalized.
+// ---------------------------------------------------------
+Limb divide2by1(Limb *q, Limb *a, const Limb *d, std::size_t n)
+{
+  std::size_t lo = n / 2, hi = n - lo;
+  LimbVector tp(n);
+
+  // High half of the quotient from the top 2*hi limbs.
+  Limb qh = divideBlock(q + lo, a + 2*lo, d + lo, hi);
+  mul(tp.data(), q + lo, hi, d, lo);
+  Limb cy = sub_n(a + lo, a + lo, tp.data(), n);
+  if (qh)
+    cy += sub_n(a + n, a + n, d, lo);
+  while (cy)
+  {
+    qh -= sub_1(q + lo, q + lo, hi, 1);
+    cy -= add_n(a + lo, a + lo, d, n);
+  }
+
+  // Low half of the quotient.
+  Limb ql = divideBlock(q, a + hi, d + hi, lo);
+  mul(tp.data(), d, hi, q, lo);
+  cy = sub_n(a, a, tp.data(), n);
+  if (ql)
+    cy += sub_n(a + lo, a + lo, d, hi);
+  while (cy)
+  {
+    sub_1(q, q, lo, 1);
+    cy -= add_n(a, a, d, n);
+  }
+  return qh;
+}
+
+// 2n-by-n division, recursive above the threshold.
+Limb divideBlock(Limb *q, Limb *a, const Limb *d, std::size_t n)
+{
+  if (n < dcThreshold())
+    return schoolbookDivide(q, a, 2*n, d, n);
+  return divide2by1(q, a, d, n);
+}
+
+// ---------------------------------------------------------
+// divideAndConquer(q,a,an,d,dn)
+// General division built from 2n-by-n blocks: a short leading
+// block of qn mod dn quotient limbs (estimated from the top
+// limbs of d and then corrected), followed by full dn-limb
+// blocks. Same contract as schoolbookDivide.
+// ---------------------------------------------------------
+Limb divideAndConquer(Limb *q, Limb *a, std::size_t an,
+                      const Limb *d, std::size_t dn)
+{
+  std::size_t qn = an - dn;
+  if (qn == 0)
+    return schoolbookDivide(q, a, an, d, dn);
+
+  std::size_t first = qn % dn ? qn % dn : dn;
+  Limb *qp = q + qn - first;
+  Limb *np = a + an - first;
+  const Limb *dEnd = d + dn;
+
+  Limb qh = divideBlock(qp, np - first, dEnd - first, first);
+  if (first != dn)
+  {
+    // Account for the low dn-first divisor limbs ignored above.
+    LimbVector tp(dn);
+    if (first > dn - first)
+      mul(tp.data(), qp, first, d, dn - first);
+    else
+      mul(tp.data(), d, dn - first, qp, first);
+    Limb cy = sub_n(np - dn, np - dn, tp.data(), dn);
+    if (qh)
+      cy += sub_n(np - dn + first, np - dn + first, d, dn - first);
+    while (cy)
+    {
+      qh -= sub_1(qp, qp, first, 1);
+      cy -= add_n(np - dn, np - dn, d, dn);
+    }
+  }
+
+  // Remaining blocks; each partial remainder is below d.
+  for (std::size_t left = qn - first; left > 0; left -= dn)
+  {
+    qp -= dn;
+    np -= dn;
+    divideBlock(qp, np - dn, d, dn);
+  }
+  return qh;
+}
+
+// ---------------------------------------------------------
+// invert(v,d,n)
+// v[0..n] ~ floor((B^2n - 1) / d) for a normalized n-limb d,
+// correct to within a few units (exact below the Newton
+// threshold). One Newton step lifts the reciprocal of the
+// top h > n/2 limbs of d to full precision; the extra guard
+// limb in h keeps the error from growing between levels.
+// ---------------------------------------------------------
+void invert(Limb *v, const Limb *d, std::size_t n)
+{
+  if (n < newtonThreshold())
+  {
+    LimbVector a(2*n, ~Limb(0)), q(n);
+    v[n] = n < dcThreshold()
+             ? schoolbookDivide(q.data(), a.data(), 2*n, d, n)
+             : divideAndConquer(q.data(), a.data(), 2*n, d, n);
+    std::copy(q.begin(), q.end(), v);
+    return;
+  }
+
+  std::size_t h = n / 2 + 2, l = n - h;
+  LimbVector vh(h + 1);
+  invert(vh.data(), d + l, h);
+
+  // e = B^(n+h) - d*vh, kept as sign and magnitude.
+  LimbVector e(n + h + 1);
+  mul(e.data(), d, n, vh.data(), h + 1);
+  bool negative = e[n+h] != 0;
+  if (negative)
+  {
+    --e[n+h];
+  }
+  else
+  {
+    for (std::size_t i = 0; i < n + h; ++i)
+      e[i] = ~e[i];
+    add_1(e.data(), e.data(), n + h, 1);
+  }
+
+  // v = vh*B^l +/- floor(vh*e / B^2h). Limbs of e below
+  // B^(h-1) move the correction by less than one unit.
+  std::size_t drop = h - 1;
+  const Limb *et = e.data() + drop;
+  std::size_t en = normalizedSize(et, e.size() - drop);
+  LimbVector w(n + 2);
+  std::copy(vh.begin(), vh.end(), w.begin() + l);
+  if (en > 0)
+  {
+    LimbVector p(en + h + 1);
+    if (en >= h + 1)
+      mul(p.data(), et, en, vh.data(), h + 1);
+    else
+      mul(p.data(), vh.data(), h + 1, et, en);
+    std::size_t shift = 2*h - drop;
+    if (p.size() > shift)
+    {
+      const Limb *c = p.data() + shift;
+      std::size_t cn = normalizedSize(c, p.size() - shift);
+      if (negative)
+        sub(w.data(), w.data(), n + 2, c, cn);
+      else
+        add(w.data(), w.data(), n + 2, c, cn);
+    }
+  }
+  std::copy(w.begin(), w.begin() + n + 1, v);
+}
+
+// ---------------------------------------------------------
+// divideBarrett(q,a,an,d,dn,v,in)
+// Division with a precomputed reciprocal v = invert() of the
+// top `in` limbs of d. Quotient blocks of up to `in` limbs
+// (in - 1 when the reciprocal is for a truncated divisor) are
+// estimated with one multiplication by v, then made exact
+// with one multiplication by d and a few add-backs or
+// subtractions, since the estimate is off by a small amount
+// in either direction.
+// Same contract as schoolbookDivide.
+// ---------------------------------------------------------
+Limb divideBarrett(Limb *q, Limb *a, std::size_t an,
+                   const Limb *d, std::size_t dn,
+                   const Limb *v, std::size_t in)
+{
+  Limb *top = a + an - dn;
+  Limb qh = cmp(top, d, dn) >= 0;
+  if (qh)
+    sub_n(top, top, d, dn);
+
+  std::size_t kmax = in == dn ? dn : in - 1;
+  LimbVector p(kmax + in + 2), t(kmax + dn);
+  for (std::size_t qn = an - dn; qn > 0;)
+  {
+    std::size_t k = std::min(kmax, qn);
+    qn -= k;
+    Limb *w = a + qn;  // w[0..dn+k) < d*B^k
+
+    // Estimate from the top k+1 limbs of the window.
+    mul(p.data(), v, in + 1, w + dn - 1, k + 1);
+    Limb *qe = p.data() + in + 1;
+    if (qe[k] != 0)
+    {
+      std::fill(qe, qe + k, ~Limb(0));
+      qe[k] = 0;
+    }
+
+    mul(t.data(), d, dn, qe, k);
+    Limb borrow = sub_n(w, w, t.data(), dn + k);
+    while (borrow)
+    {
+      sub_1(qe, qe, k, 1);
+      borrow -= add(w, w, dn + k, d, dn);
+    }
+    while (normalizedSize(w + dn, k) != 0 || cmp(w, d, dn) >= 0)
+    {
+      sub(w, w, dn + k, d, dn);
+      add_1(qe, qe, k, 1);
+    }
+    std::copy(qe, qe + k, q + qn);
+  }
+  return qh;
+}
+
+} // namespace
+
+Limb divrem_1(Limb *q, const Limb *a, std::size_t n, Limb d)
+{
+  unsigned s = leadingZeros(d);
+  Reciprocal rec(d << s);
+  if (n == 0)
+    return 0;
+
+  Limb r = 0;
+  if (s == 0)
+  {
+    for (std::size_t i = n; i-- > 0;)
+      q[i] = rec.divide(r, a[i], r);
+    return r;
+  }
+
+  // Shift the dividend on the fly; the quotient is unchanged.
+  r = a[n-1] >> (64 - s);
+  for (std::size_t i = n; i-- > 0;)
+  {
+    Limb u0 = (a[i] << s) | (i ? a[i-1] >> (64 - s) : 0);
+    q[i] = rec.divide(r, u0, r);
+  }
+  return r >> s;
+}
+
+void divrem(Limb *q, Limb *r, const Limb *a, std::size_t an,
+            const Limb *d, std::size_t dn)
+{
+  if (dn == 1)
+  {
+    r[0] = divrem_1(q, a, an, d[0]);
+    return;
+  }
+
+  // Normalize so the divisor's top bit is set. The extra
+  // dividend limb keeps the top quotient limb at zero.
+  unsigned s = leadingZeros(d[dn-1]);
+  LimbVector dd(dn), aa(an + 1);
+  if (s)
+  {
+    lshift(dd.data(), d, dn, s);
+    aa[an] = lshift(aa.data(), a, an, s);
+  }
+  else
+  {
+    std::copy(d, d + dn, dd.begin());
+    std::copy(a, a + an, aa.begin());
+    aa[an] = 0;
+  }
+
+  // A reciprocal of more divisor limbs than quotient limbs
+  // would be wasted, so short quotients invert only the top.
+  std::size_t in = std::min(dn, an - dn + 2);
+  if (in >= newtonThreshold())
+  {
+    LimbVector v(in + 1);
+    invert(v.data(), dd.data() + dn - in, in);
+    divideBarrett(q, aa.data(), an + 1, dd.data(), dn, v.data(), in);
+  }
+  else if (dn < dcThreshold())
+    schoolbookDivide(q, aa.data(), an + 1, dd.data(), dn);
+  else
+    divideAndConquer(q, aa.data(), an + 1, dd.data(), dn);
+
+  if (s)
+    rshift(r, aa.data(), dn, s);
+  else
+    std::copy(aa.begin(), aa.begin() + dn, r);
+}
+
+// ---------------------------------------------------------
+// Divisor
+// ---------------------------------------------------------
+Divisor::Divisor(const Limb *d, std::size_t dn, bool reciprocal)
+  : norm(d, d + dn), shift(leadingZeros(d[dn-1]))
+{
+  if (shift)
+    lshift(norm.data(), d, dn, shift);
+  if (dn >= 2 && (reciprocal || dn >= newtonThreshold()))
+  {
+    inverse.resize(dn + 1);
+    invert(inverse.data(), norm.data(), dn);
+  }
+}
+
+void Divisor::divrem(Limb *q, Limb *r, const Limb *a, std::size_t an) const
+{
+  std::size_t dn = norm.size();
+  if (dn == 1)
+  {
+    r[0] = divrem_1(q, a, an, norm[0] >> shift);
+    return;
+  }
+
+  LimbVector aa(an + 1);
+  if (shift)
+    aa[an] = lshift(aa.data(), a, an, shift);
+  else
+    std::copy(a, a + an, aa.begin());
+
+  if (!inverse.empty())
+    divideBarrett(q, aa.data(), an + 1, norm.data(), dn,
+                  inverse.data(), dn);
+  else if (dn < dcThreshold())
+    schoolbookDivide(q, aa.data(), an + 1, norm.data(), dn);
+  else
+    divideAndConquer(q, aa.data(), an + 1, norm.data(), dn);
+
+  if (shift)
+    rshift(r, aa.data(), dn, shift);
+  else
+    std::copy(aa.begin(), aa.begin() + dn, r);
+}
+
+} // namespace limb
+
+// ---------------------------------------------------------
+// divideThresholds()
+// Process-wide division crossover points, in limbs.
+// ---------------------------------------------------------
+Integer::DivideThresholds &Integer::divideThresholds()
+{
+  static DivideThresholds thresholds;
+  return thresholds;
+}
@@ -0,0 +1,633 @@
+// ---------------------------------------------------------
+// File: Gcd.cpp
+// Greatest common divisor of limb arrays.
+//
+// Author: agent <agent@local>
+// Last Modification: 2026-10-16
+//
+// Single limbs use binary GCD. Mid-size operands use Lehmer's
+// algorithm: the leading two limbs drive a run of single-
+// precision Euclid steps whose cofactor matrix is then applied
+// to the full numbers. Large operands use the subquadratic
+// half-GCD of Schonhage in Moller's formulation, which finds
+// the matrix for the top half recursively.
+//
+// All cofactor matrices have non-negative entries and
+// determinant 1, so (a;b) = M (alpha;beta) is inverted as
+// alpha = u11*a - u01*b, beta = u00*b - u10*a.
+// ---------------------------------------------------------
+
+#include "Limb.h"
+#include <algorithm>  // for std::max, std::swap, std::copy, std::fill
+
+namespace limb
+{
+
+namespace
+{
+
+using Nat = LimbVector;
+
+const Limb HIGH_BIT = Limb(1) << 63;
+const Limb HALF_LIMB = Limb(1) << 32;
+
+void trim(Nat &x)
+{
+  x.resize(normalizedSize(x.data(), x.size()));
+}
+
+// x += y * q
+void addMul(Nat &x, const Nat &y, const Nat &q)
+{
+  if (y.empty() || q.empty())
+    return;
+  Nat p(y.size() + q.size());
+  if (y.size() >= q.size())
+    mul(p.data(), y.data(), y.size(), q.data(), q.size());
+  else
+    mul(p.data(), q.data(), q.size(), y.data(), y.size());
+  trim(p);
+
+  if (x.size() < p.size())
+    x.resize(p.size());
+  x.push_back(0);
+  add(x.data(), x.data(), x.size(), p.data(), p.size());
+  trim(x);
+}
+
+// ---------------------------------------------------------
+// Matrix1
+// Single-limb cofactor matrix produced by hgcd2.
+// ---------------------------------------------------------
+struct Matrix1
+{
+  Limb u[2][2];
+};
+
+// ---------------------------------------------------------
+// Matrix
+// Multi-limb cofactor matrix, initially the identity.
+// ---------------------------------------------------------
+struct Matrix
+{
+  Nat u[2][2] = {{Nat{1}, Nat{}}, {Nat{}, Nat{1}}};
+
+  // M <- M * M1 for a single-limb M1.
+  void mul1(const Matrix1 &m)
+  {
+    for (int row = 0; row < 2; ++row)
+    {
+      Nat c0, c1;
+      addMul(c0, u[row][0], Nat{m.u[0][0]});
+      addMul(c0, u[row][1], Nat{m.u[1][0]});
+      addMul(c1, u[row][0], Nat{m.u[0][1]});
+      addMul(c1, u[row][1], Nat{m.u[1][1]});
+      u[row][0] = std::move(c0);
+      u[row][1] = std::move(c1);
+    }
+  }
+
+  // M <- M * M1.
+  void mul(const Matrix &m)
+  {
+    for (int row = 0; row < 2; ++row)
+    {
+      Nat c0, c1;
+      addMul(c0, u[row][0], m.u[0][0]);
+      addMul(c0, u[row][1], m.u[1][0]);
+      addMul(c1, u[row][0], m.u[0][1]);
+      addMul(c1, u[row][1], m.u[1][1]);
+      u[row][0] = std::move(c0);
+      u[row][1] = std::move(c1);
+    }
+  }
+
+  // Records the step "column (1-target) was subtracted q times
+  // from column target": col[target] += q * col[1-target].
+  void addQuotient(const Nat &q, int target)
+  {
+    for (int row = 0; row < 2; ++row)
+      addMul(u[row][target], u[row][1-target], q);
+  }
+};
+
+// ---------------------------------------------------------
+// hgcd2(ah,al,bh,bl,M)
+// Lehmer step on the leading two limbs a = ah:al, b = bh:bl.
+// Euclid's algorithm runs on these 128-bit values as long as
+// every remainder stays at or above 2^65; by Jebelean's
+// condition the quotients are then those of the full numbers,
+// and the cofactors stay below 2^64. Once the larger value
+// has less than 32 bits in its high limb, the steps continue
+// on the top 96 bits in single precision, with the margin
+// scaled down to 2^33. Returns false if not even the first
+// step qualifies.
+// ---------------------------------------------------------
+bool hgcd2(Limb ah, Limb al, Limb bh, Limb bl, Matrix1 &M)
+{
+  if (ah < 2 || bh < 2)
+    return false;
+
+  const DoubleLimb limit = static_cast<DoubleLimb>(2) << 64;
+  DoubleLimb a = (static_cast<DoubleLimb>(ah) << 64) | al;
+  DoubleLimb b = (static_cast<DoubleLimb>(bh) << 64) | bl;
+
+  // The first quotient is at least one: subtract once.
+  bool reduceA = a > b;
+  if (reduceA)
+    a -= b;
+  else
+    b -= a;
+  if ((reduceA ? a : b) < limit)
+    return false;
+
+  // Reducing a by q*b adds q times column 0 to column 1, and
+  // reducing b adds column 1 to column 0.
+  Limb u[2][2] = {{1, reduceA ? Limb(1) : 0}, {reduceA ? 0 : Limb(1), 1}};
+  auto record = [&u](bool reducedA, Limb q) {
+    int to = reducedA ? 1 : 0;
+    u[0][to] += q * u[0][1-to];
+    u[1][to] += q * u[1][1-to];
+  };
+
+  // Double precision: reduce the value with the larger high
+  // limb. Equal high limbs give no reliable quotient. A step
+  // whose full quotient would take the remainder below the
+  // limit records one subtraction less and ends the run.
+  reduceA = (a >> 64) >= (b >> 64);
+  bool single = false;
+  for (;;)
+  {
+    DoubleLimb &x = reduceA ? a : b;
+    DoubleLimb y = reduceA ? b : a;
+    Limb yh = static_cast<Limb>(y >> 64);
+    if (static_cast<Limb>(x >> 64) == yh)
+      break;
+    if ((x >> 64) < HALF_LIMB)
+    {
+      single = true;
+      break;
+    }
+
+    x -= y;
+    if (x < limit)
+      break;
+    Limb q = 1;
+    bool last = false;
+    if (static_cast<Limb>(x >> 64) > yh)
+    {
+      q = static_cast<Limb>(x / y);
+      x %= y;
+      if (x < limit)
+        last = true;
+      else
+        ++q;
+    }
+    record(reduceA, q);
+    if (last)
+      break;
+    reduceA = !reduceA;
+  }
+
+  // Single precision on bits 32..95, both values now fitting a
+  // limb, with the same rules.
+  if (single)
+  {
+    const Limb smallLimit = Limb(1) << 33;
+    Limb sa = static_cast<Limb>(a >> 32), sb = static_cast<Limb>(b >> 32);
+    for (;;)
+    {
+      Limb &x = reduceA ? sa : sb;
+      Limb y = reduceA ? sb : sa;
+      x -= y;
+      if (x < smallLimit)
+        break;
+      Limb q = 1;
+      bool last = false;
+      if (x > y)
+      {
+        q = x / y;
+        x %= y;
+        if (x < smallLimit)
+          last = true;
+        else
+          ++q;
+      }
+      record(reduceA, q);
+      if (last)
+        break;
+      reduceA = !reduceA;
+    }
+  }
+
+  for (int i = 0; i < 2; ++i)
+    for (int j = 0; j < 2; ++j)
+      M.u[i][j] = u[i][j];
+  return true;
+}
+
+// ---------------------------------------------------------
+// applyInverse1(M,a,b,n)
+// (a;b) <- M^{-1} (a;b) over n limbs for a single-limb M.
+// Returns the new common size.
+// ---------------------------------------------------------
+std::size_t applyInverse1(const Matrix1 &M, Limb *a, Limb *b,
+                          std::size_t n)
+{
+  LimbVector t(a, a + n);
+  mul_1(a, t.data(), n, M.u[1][1]);
+  submul_1(a, b, n, M.u[0][1]);
+  mul_1(b, b, n, M.u[0][0]);
+  submul_1(b, t.data(), n, M.u[1][0]);
+  return (a[n-1] | b[n-1]) == 0 ? n - 1 : n;
+}
+
+// Reads the 128 bits of x starting at the top set bit of mask.
+void topTwoLimbs(const Limb *a, const Limb *b, std::size_t n,
+                 Limb &ah, Limb &al, Limb &bh, Limb &bl)
+{
+  Limb mask = a[n-1] | b[n-1];
+  ah = a[n-1]; al = a[n-2];
+  bh = b[n-1]; bl = b[n-2];
+  if (!(mask & HIGH_BIT))
+  {
+    unsigned s = static_cast<unsigned>(__builtin_clzll(mask));
+    Limb a3 = n >= 3 ? a[n-3] : 0, b3 = n >= 3 ? b[n-3] : 0;
+    ah = (ah << s) | (al >> (64 - s));
+    al = (al << s) | (a3 >> (64 - s));
+    bh = (bh << s) | (bl >> (64 - s));
+    bl = (bl << s) | (b3 >> (64 - s));
+  }
+}
+
+// ---------------------------------------------------------
+// subdivStep(a,b,n,s,M)
+// One subtraction followed by one division on the n-limb a
+// and b, recorded in M. Refuses (returns 0) if either result
+// would have s limbs or fewer; otherwise returns the new size.
+// ---------------------------------------------------------
+std::size_t subdivStep(Limb *a, Limb *b, std::size_t n, std::size_t s,
+                       Matrix &M)
+{
+  std::size_t an = normalizedSize(a, n), bn = normalizedSize(b, n);
+  int swapped = 0;
+
+  // Arrange a < b.
+  auto order = [&]() -> bool {
+    if (an == bn)
+    {
+      int c = cmp(a, b, an);
+      if (c == 0)
+        return false;
+      if (c > 0)
+      {
+        std::swap(a, b);
+        swapped ^= 1;
+      }
+    }
+    else if (an > bn)
+    {
+      std::swap(a, b);
+      std::swap(an, bn);
+      swapped ^= 1;
+    }
+    return true;
+  };
+
+  if (!order() || an <= s)
+    return 0;
+
+  sub(b, b, bn, a, an);
+  bn = normalizedSize(b, bn);
+  if (bn <= s)
+  {
+    Limb cy = add(b, a, an, b, bn);
+    if (cy)
+      b[an] = cy;
+    return 0;
+  }
+
+  // The subtraction is a quotient of one.
+  int target = swapped ? 1 : 0;
+  M.addQuotient(Nat{1}, target);
+  if (an == bn && cmp(a, b, an) == 0)
+    return an;
+  order();
+  target = swapped ? 1 : 0;
+
+  std::size_t qn = bn - an + 1;
+  Nat q(qn);
+  divrem(q.data(), b, b, bn, a, an);
+  bn = normalizedSize(b, an);
+
+  if (bn <= s)
+  {
+    // Quotient one too large for the size bound: add a back.
+    Limb cy = add(b, a, an, b, bn);
+    std::fill(b + an, b + n, 0);
+    if (cy)
+      b[an++] = cy;
+    sub_1(q.data(), q.data(), qn, 1);
+  }
+  else
+  {
+    std::fill(b + an, b + n, 0);
+  }
+
+  trim(q);
+  M.addQuotient(q, target);
+  return an;
+}
+
+// ---------------------------------------------------------
+// hgcdStep(n,a,b,s,M)
+// One Lehmer step (or a subtraction/division step when hgcd2
+// refuses), keeping both values above s limbs.
+// ---------------------------------------------------------
+std::size_t hgcdStep(std::size_t n, Limb *a, Limb *b, std::size_t s,
+                     Matrix &M)
+{
+  Limb mask = a[n-1] | b[n-1];
+  if (n != s + 1 || mask >= 4)
+  {
+    Limb ah, al, bh, bl;
+    if (n == s + 1)
+    {
+      ah = a[n-1]; al = a[n-2];
+      bh = b[n-1]; bl = b[n-2];
+    }
+    else
+    {
+      topTwoLimbs(a, b, n, ah, al, bh, bl);
+    }
+
+    Matrix1 M1;
+    if (hgcd2(ah, al, bh, bl, M1))
+    {
+      M.mul1(M1);
+      return applyInverse1(M1, a, b, n);
+    }
+  }
+  return subdivStep(a, b, n, s, M);
+}
+
+// ---------------------------------------------------------
+// adjust(M,n,a,b,p)
+// The limbs a[p..n), b[p..n) hold the top parts already
+// reduced by M; the low p limbs are still the original ones.
+// Completes (a;b) <- M^{-1} (a;b) and returns the new size.
+// ---------------------------------------------------------
+std::size_t adjust(const Matrix &M, std::size_t n, Limb *a, Limb *b,
+                   std::size_t p)
+{
+  Nat a0(a, a + p), b0(b, b + p);
+  trim(a0);
+  trim(b0);
+
+  // alpha = top(a)*B^p + u11*a0 - u01*b0, and similarly beta.
+  // The results may be one limb longer than n but never longer
+  // than the original operands, so they fit in place.
+  auto combine = [&](Limb *x, const Nat &plus, const Nat &plusBy,
+                     const Nat &minus, const Nat &minusBy) {
+    Nat acc(x, x + n);
+    std::fill(acc.begin(), acc.begin() + p, 0);
+    addMul(acc, plus, plusBy);
+    Nat minusTerm;
+    addMul(minusTerm, minus, minusBy);
+    if (!minusTerm.empty())
+      sub(acc.data(), acc.data(), acc.size(),
+          minusTerm.data(), minusTerm.size());
+    trim(acc);
+    std::fill(x, x + n, 0);
+    std::copy(acc.begin(), acc.end(), x);
+    return acc.size();
+  };
+
+  std::size_t an = combine(a, a0, M.u[1][1], b0, M.u[0][1]);
+  std::size_t bn = combine(b, b0, M.u[0][0], a0, M.u[1][0]);
+  return std::max(an, bn);
+}
+
+std::size_t hgcdBasecase()
+{
+  return std::max<std::size_t>(
+    Integer::gcdThresholds().halfGcdBasecase, 8);
+}
+
+// ---------------------------------------------------------
+// hgcd(a,b,n,M)
+// Half-GCD: reduces the n-limb a and b in place until their
+// difference fits in n/2+1 limbs, accumulating the cofactors
+// in M (which must be the identity on entry). Returns the new
+// size, or 0 if no reduction was possible.
+// ---------------------------------------------------------
+std::size_t hgcd(Limb *a, Limb *b, std::size_t n, Matrix &M)
+{
+  std::size_t s = n/2 + 1;
+  if (n <= s)
+    return 0;
+
+  bool success = false;
+  if (n >= hgcdBasecase())
+  {
+    std::size_t n2 = (3*n)/4 + 1;
+    std::size_t p = n/2;
+
+    // Reduce using the top half, computed recursively.
+    std::size_t nn = hgcd(a + p, b + p, n - p, M);
+    if (nn)
+    {
+      n = adjust(M, p + nn, a, b, p);
+      success = true;
+    }
+
+    while (n > n2)
+    {
+      nn = hgcdStep(n, a, b, s, M);
+      if (!nn)
+        return success ? n : 0;
+      n = nn;
+      success = true;
+    }
+
+    // Second recursive call on the top of what is left.
+    if (n > s + 2)
+    {
+      p = 2*s - n + 1;
+      Matrix M1;
+      nn = hgcd(a + p, b + p, n - p, M1);
+      if (nn)
+      {
+        n = adjust(M1, p + nn, a, b, p);
+        M.mul(M1);
+        success = true;
+      }
+    }
+  }
+
+  for (;;)
+  {
+    std::size_t nn = hgcdStep(n, a, b, s, M);
+    if (!nn)
+      return success ? n : 0;
+    n = nn;
+    success = true;
+  }
+}
+
+Limb binaryGcd(Limb u, Limb v)
+{
+  if (u == 0)
+    return v;
+  if (v == 0)
+    return u;
+  int shift = __builtin_ctzll(u | v);
+  u >>= __builtin_ctzll(u);
+  do
+  {
+    v >>= __builtin_ctzll(v);
+    if (u > v)
+      std::swap(u, v);
+    v -= u;
+  } while (v != 0);
+  return u << shift;
+}
+
+// Value of a one- or two-limb span.
+DoubleLimb join(const Limb *w, std::size_t wn)
+{
+  DoubleLimb r = w[0];
+  if (wn > 1)
+    r |= static_cast<DoubleLimb>(w[1]) << 64;
+  return r;
+}
+
+// ---------------------------------------------------------
+// gcdDouble(g,x,y)
+// Writes gcd(x,y) of two nonzero double-limb values to g and
+// returns its size: Euclid until both fit a limb, then binary.
+// ---------------------------------------------------------
+std::size_t gcdDouble(Limb *g, DoubleLimb x, DoubleLimb y)
+{
+  while (y != 0 && ((x | y) >> 64) != 0)
+  {
+    x %= y;
+    std::swap(x, y);
+  }
+  if (y == 0)
+  {
+    // A two-limb gcd means both operands had two limbs, so g
+    // has room for it.
+    g[0] = static_cast<Limb>(x);
+    if ((x >> 64) == 0)
+      return 1;
+    g[1] = static_cast<Limb>(x >> 64);
+    return 2;
+  }
+  g[0] = binaryGcd(static_cast<Limb>(x), static_cast<Limb>(y));
+  return 1;
+}
+
+} // namespace
+
+std::size_t gcd(Limb *g, const Limb *a, std::size_t an,
+                const Limb *b, std::size_t bn)
+{
+  // Word-sized operands need no scratch storage.
+  if (an <= 2 && bn <= 2)
+    return gcdDouble(g, join(a, an), join(b, bn));
+
+  Nat u(a, a + an), v(b, b + bn);
+  if (u.size() < v.size() || (u.size() == v.size()
+                              && cmp(u.data(), v.data(), u.size()) < 0))
+    std::swap(u, v);
+
+  // Bring both operands to the same size with one division.
+  if (v.size() < u.size())
+  {
+    Nat q(u.size() - v.size() + 1), r(v.size());
+    divrem(q.data(), r.data(), u.data(), u.size(), v.data(), v.size());
+    trim(r);
+    u = std::move(v);
+    v = std::move(r);
+    if (v.empty())
+    {
+      std::copy(u.begin(), u.end(), g);
+      return u.size();
+    }
+    v.resize(u.size());
+  }
+
+  std::size_t n = u.size();
+  const std::size_t halfGcd = std::max<std::size_t>(
+    Integer::gcdThresholds().halfGcd, 8);
+
+  while (n > 2)
+  {
+    std::size_t nn = 0;
+    if (n >= halfGcd)
+    {
+      // Half-GCD on the top third of the limbs.
+      std::size_t p = 2*n/3;
+      Matrix M;
+      nn = hgcd(u.data() + p, v.data() + p, n - p, M);
+      if (nn)
+        nn = adjust(M, p + nn, u.data(), v.data(), p);
+    }
+    else
+    {
+      Limb ah, al, bh, bl;
+      topTwoLimbs(u.data(), v.data(), n, ah, al, bh, bl);
+      Matrix1 M1;
+      if (hgcd2(ah, al, bh, bl, M1))
+        nn = applyInverse1(M1, u.data(), v.data(), n);
+    }
+
+    if (!nn)
+    {
+      // No cofactor step possible: one plain Euclid division.
+      std::size_t un = normalizedSize(u.data(), n);
+      std::size_t vn = normalizedSize(v.data(), n);
+      if (un < vn || (un == vn && cmp(u.data(), v.data(), un) < 0))
+      {
+        std::swap(u, v);
+        std::swap(un, vn);
+      }
+      if (vn == 0)
+        break;
+      Nat q(un - vn + 1), r(vn);
+      divrem(q.data(), r.data(), u.data(), un, v.data(), vn);
+      std::fill(u.begin(), u.end(), 0);
+      std::copy(r.begin(), r.end(), u.begin());
+      nn = std::max(normalizedSize(u.data(), n), vn);
+    }
+    n = nn;
+    if (normalizedSize(u.data(), n) == 0 || normalizedSize(v.data(), n) == 0)
+      break;
+  }
+
+  // Finish with double- and single-limb Euclid.
+  std::size_t un = normalizedSize(u.data(), n);
+  std::size_t vn = normalizedSize(v.data(), n);
+  if (un == 0 || vn == 0)
+  {
+    const Nat &x = un ? u : v;
+    std::size_t xn = un ? un : vn;
+    std::copy(x.begin(), x.begin() + xn, g);
+    return xn;
+  }
+
+  return gcdDouble(g, join(u.data(), un), join(v.data(), vn));
+}
+
+} // namespace limb
+
+// ---------------------------------------------------------
+// gcdThresholds()
+// Process-wide GCD crossover points, in limbs.
+// ---------------------------------------------------------
+Integer::GcdThresholds &Integer::gcdThresholds()
+{
+  static GcdThresholds thresholds;
+  return thresholds;
+}
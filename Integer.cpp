@@ -1,47 +1,77 @@
 // ---------------------------------------------------------
 // File: Integer.cpp
 // Implementation of arbitrary-precision signed integers using
-// base-100 digits stored in std::vector<DigitType>.
+// base-2^64 limbs stored in a LimbVector. Conversion to and
+// from digit strings happens only at the I/O boundary and is
+// done by the subquadratic routines in Convert.cpp.
 //
 // Author: Abdoulie Jallow <Jallow.jku@gmail.com>
-// Last Modification: 2025-04-23
+// Last Modification: 2026-10-16
 //
 // Provides normalization, comparison, arithmetic, and I/O
 // for Integer class following rule-of-zero and common style.
 // ---------------------------------------------------------
 
 #include "Integer.h"
+#include "Limb.h"
+#include "Stats.h"
+#include "ThreadPool.h"
 #include <vector>
-#include <stdexcept>  // for std::invalid_argument
-#include <algorithm>  // for std::max, std::reverse
-#include <iomanip>    // for std::setw, std::setfill
-#include <cmath>      // for std::abs
-#include <limits>     // for numeric_limits
+#include <stdexcept>  // for std::invalid_argument, std::domain_error
+#include <algorithm>  // for std::min, std::max, std::reverse, std::transform
+#include <cmath>      // for std::ldexp, std::frexp, std::trunc
 
-// Use unsigned char for digits 0-99
+using limb::Limb;
+using limb::DoubleLimb;
+
+// Digits accepted by the compatibility constructors are base 100.
 using DigitType = unsigned char;
 const int BASE = 100;
 
+// ---------------------------------------------------------
+// fromDigits(s,len,base)
+// Magnitude of len digit values (most significant first)
+// via limb::set_str.
+// Preconditions: every s[i] < base.
+// ---------------------------------------------------------
+static LimbVector fromDigits(const unsigned char *s, size_t len,
+                             unsigned base)
+{
+  LimbVector v;
+  if (len == 0)
+    return v;
+  v.resize(limb::set_str_size(len, base));
+  v.resize(limb::set_str(v.data(), s, len, base));
+  return v;
+}
+
+// Value of an ASCII digit or letter, or 36 if it is neither.
+static unsigned digitValue(char c)
+{
+  if (c >= '0' && c <= '9')
+    return static_cast<unsigned>(c - '0');
+  if (c >= 'a' && c <= 'z')
+    return static_cast<unsigned>(c - 'a') + 10;
+  if (c >= 'A' && c <= 'Z')
+    return static_cast<unsigned>(c - 'A') + 10;
+  return 36;
+}
+
 // ---------------------------------------------------------
 // normalize()
-// Remove leading zeros, ensure canonical zero form.
-// Postconditions: no trailing zeros in digits; empty means 0.
-// Effects: may clear digits and reset sign.
+// Remove leading zero limbs, ensure canonical zero form.
+// Postconditions: no trailing zeros in limbs; empty means 0.
+// Effects: may clear limbs and reset sign.
 // ---------------------------------------------------------
 void Integer::normalize()
 {
-  while (digits.size() > 1 && digits.back() == 0)
+  INTEGER_STATS_SCOPE(stats::Op::IntegerNormalize, limbs.size());
+  while (!limbs.empty() && limbs.back() == 0)
   {
-    digits.pop_back();
+    limbs.pop_back();
   }
 
-  if (digits.empty() || (digits.size() == 1 && digits[0] == 0))
-  {
-    digits.clear();  // canonical zero
-    sign = false;    // zero is non-negative
-  }
-
-  if (digits.empty())
+  if (limbs.empty())
   {
     sign = false;    // enforce non-negative zero
   }
@@ -55,21 +85,12 @@ void Integer::normalize()
 int Integer::compareMagnitude(const Integer &a,
                               const Integer &b)
 {
-  if (a.digits.size() < b.digits.size())
+  if (a.limbs.size() < b.limbs.size())
     return -1;
-  if (a.digits.size() > b.digits.size())
+  if (a.limbs.size() > b.limbs.size())
     return 1;
-  if (a.digits.empty())
-    return 0;  // both zero
 
-  for (int i = static_cast<int>(a.digits.size()) - 1; i >= 0; --i)
-  {
-    if (a.digits[i] < b.digits[i])
-      return -1;
-    if (a.digits[i] > b.digits[i])
-      return 1;
-  }
-  return 0;
+  return limb::cmp(a.limbs.data(), b.limbs.data(), a.limbs.size());
 }
 
 // ---------------------------------------------------------
@@ -79,27 +100,15 @@ int Integer::compareMagnitude(const Integer &a,
 Integer Integer::addMagnitude(const Integer &a,
                               const Integer &b)
 {
-  const auto &d1 = a.digits;
-  const auto &d2 = b.digits;
-  size_t n1 = d1.size(), n2 = d2.size();
-  size_t m = std::max(n1, n2);
+  const auto &big = a.limbs.size() >= b.limbs.size() ? a.limbs : b.limbs;
+  const auto &small = a.limbs.size() >= b.limbs.size() ? b.limbs : a.limbs;
+  size_t n1 = big.size(), n2 = small.size();
 
-  std::vector<DigitType> res;
-  res.reserve(m + 1);
-  int carry = 0;
+  Integer result;
+  auto &res = result.limbs;
+  res.resize(n1 + 1);
+  res[n1] = limb::add(res.data(), big.data(), n1, small.data(), n2);
 
-  for (size_t i = 0; i < m; ++i)
-  {
-    int sum = carry;
-    if (i < n1) sum += d1[i];
-    if (i < n2) sum += d2[i];
-    res.push_back(static_cast<DigitType>(sum % BASE));
-    carry = sum / BASE;
-  }
-  if (carry > 0)
-    res.push_back(static_cast<DigitType>(carry));
-
-  Integer result(false, std::move(res));
   result.normalize();
   return result;
 }
@@ -111,35 +120,35 @@ Integer Integer::addMagnitude(const Integer &a,
 Integer Integer::subtractMagnitude(const Integer &a,
                                    const Integer &b)
 {
-  const auto &d1 = a.digits;
-  const auto &d2 = b.digits;
-  size_t n1 = d1.size(), n2 = d2.size();
-
-  std::vector<DigitType> res;
-  res.reserve(n1);
-  int borrow = 0;
-
-  for (size_t i = 0; i < n1; ++i)
-  {
-    int diff = d1[i] - borrow;
-    if (i < n2) diff -= d2[i];
-    if (diff < 0)
-    {
-      diff += BASE;
-      borrow = 1;
-    }
-    else
-    {
-      borrow = 0;
-    }
-    res.push_back(static_cast<DigitType>(diff));
-  }
+  Integer result;
+  auto &res = result.limbs;
+  res.resize(a.limbs.size());
+  limb::sub(res.data(), a.limbs.data(), a.limbs.size(),
+            b.limbs.data(), b.limbs.size());
 
-  Integer result(false, std::move(res));
   result.normalize();
   return result;
 }
 
+// ---------------------------------------------------------
+// isWord(), word(), fromWords(negative,lo,hi)
+// Single-limb view used by the word-sized fast paths.
+// ---------------------------------------------------------
+bool Integer::isWord() const { return limbs.size() <= 1; }
+
+Limb Integer::word() const { return limbs.empty() ? 0 : limbs[0]; }
+
+Integer Integer::fromWords(bool negative, Limb lo, Limb hi)
+{
+  Integer r;
+  r.sign = negative;
+  r.limbs.push_back(lo);
+  if (hi)
+    r.limbs.push_back(hi);
+  r.normalize();
+  return r;
+}
+
 // ---------------------------------------------------------
 // Integer(i)
 // Construct from built-in long long.
@@ -150,27 +159,18 @@ Integer::Integer(long long i)
   if (i == 0)
     return;
 
-  unsigned long long v;
-  if (i == std::numeric_limits<long long>::min())
-  {
-    v = static_cast<unsigned long long>(
-          std::numeric_limits<long long>::max()) + 1;
-  }
-  else
-  {
-    v = std::abs(i);
-  }
+  // Negate in unsigned arithmetic so LLONG_MIN is handled too.
+  unsigned long long v = static_cast<unsigned long long>(i);
+  if (i < 0)
+    v = 0ULL - v;
 
-  while (v > 0)
-  {
-    digits.push_back(static_cast<DigitType>(v % BASE));
-    v /= BASE;
-  }
+  limbs.push_back(static_cast<Limb>(v));
 }
 
 // ---------------------------------------------------------
 // Integer(s,n,d)
-// Construct from sign and C-array of digits (kept for compatibility).
+// Construct from sign and C-array of base-100 digits
+// (kept for compatibility).
 // ---------------------------------------------------------
 Integer::Integer(bool s, int n, const char *d)
   : sign(s)
@@ -181,64 +181,130 @@ Integer::Integer(bool s, int n, const char *d)
     return;
   }
 
-  int m = n;
-  while (m > 1 && d[m-1] == 0)
-    --m;
-
-  if (m == 1 && d[0] == 0)
-  {
-    sign = false;
-    return;
-  }
-
-  digits.reserve(m);
-  for (int i = 0; i < m; ++i)
+  // The digits come least significant first.
+  std::vector<DigitType> digits(static_cast<size_t>(n));
+  for (int i = 0; i < n; ++i)
   {
     if (static_cast<unsigned char>(d[i]) >= BASE || d[i] < 0)
       throw std::invalid_argument(
         "Invalid digit in char* constructor");
-    digits.push_back(static_cast<DigitType>(d[i]));
+    digits[n - 1 - i] = static_cast<DigitType>(d[i]);
   }
+  limbs = fromDigits(digits.data(), digits.size(), BASE);
   normalize();
 }
 
 // ---------------------------------------------------------
 // Integer(s,d_vec)
-// Construct from sign and digit vector.
+// Construct from sign and base-100 digit vector.
 // ---------------------------------------------------------
 Integer::Integer(bool s, std::vector<DigitType> d_vec)
-  : sign(s), digits(std::move(d_vec))
+  : sign(s)
 {
-  for (auto dig : digits)
+  for (auto dig : d_vec)
     if (dig >= BASE)
       throw std::invalid_argument(
         "Invalid digit in vector constructor");
+  std::reverse(d_vec.begin(), d_vec.end());
+  limbs = fromDigits(d_vec.data(), d_vec.size(), BASE);
   normalize();
 }
 
 // ---------------------------------------------------------
-// operator<<
-// Output decimal representation.
+// Integer(s,base)
+// Parse [+-][0x|0b]digits in base 2..36.
 // ---------------------------------------------------------
-std::ostream &operator<<(std::ostream &os, const Integer &i)
+Integer::Integer(std::string_view s, int base)
 {
-  if (i.isZero())
+  if (base < 2 || base > 36)
+    throw std::invalid_argument("Integer: base must be in 2..36");
+
+  bool negative = false;
+  if (!s.empty() && (s[0] == '+' || s[0] == '-'))
   {
-    os << "0";
-    return os;
+    negative = s[0] == '-';
+    s.remove_prefix(1);
+  }
+  if (s.size() > 2 && s[0] == '0'
+      && ((base == 16 && (s[1] == 'x' || s[1] == 'X'))
+          || (base == 2 && (s[1] == 'b' || s[1] == 'B'))))
+    s.remove_prefix(2);
+  if (s.empty())
+    throw std::invalid_argument("Integer: no digits in string");
+  INTEGER_STATS_SCOPE(stats::Op::IntegerParse,
+                      limb::set_str_size(s.size(), base));
+
+  std::vector<unsigned char> digits(s.size());
+  for (size_t i = 0; i < s.size(); ++i)
+  {
+    unsigned v = digitValue(s[i]);
+    if (v >= static_cast<unsigned>(base))
+      throw std::invalid_argument("Integer: invalid digit in string");
+    digits[i] = static_cast<unsigned char>(v);
   }
 
-  if (i.sign)
-    os << "-";
+  limbs = fromDigits(digits.data(), digits.size(),
+                     static_cast<unsigned>(base));
+  sign = negative;
+  normalize();
+}
 
-  os << static_cast<int>(i.digits.back());
-  for (int j = static_cast<int>(i.digits.size()) - 2; j >= 0; --j)
+// ---------------------------------------------------------
+// toString(base)
+// Digits via limb::get_str, mapped to '0'-'9' and 'a'-'z'.
+// ---------------------------------------------------------
+std::string Integer::toString(int base) const
+{
+  if (base < 2 || base > 36)
+    throw std::invalid_argument("Integer: base must be in 2..36");
+  if (isZero())
+    return "0";
+  INTEGER_STATS_SCOPE(stats::Op::IntegerToString, limbs.size());
+
+  unsigned b = static_cast<unsigned>(base);
+  std::string out(limb::get_str_size(limbs.size(), b) + 1, '\0');
+  unsigned char *digits = reinterpret_cast<unsigned char *>(&out[1]);
+  size_t len = limb::get_str(digits, limbs.data(), limbs.size(), b);
+
+  static const char alphabet[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+  for (size_t j = 0; j < len; ++j)
+    digits[j] = static_cast<unsigned char>(alphabet[digits[j]]);
+
+  out.resize(len + 1);
+  if (sign)
+    out[0] = '-';
+  else
+    out.erase(0, 1);
+  return out;
+}
+
+// ---------------------------------------------------------
+// operator<<
+// Output in the stream's base (decimal unless std::hex or
+// std::oct is set).
+// ---------------------------------------------------------
+std::ostream &operator<<(std::ostream &os, const Integer &i)
+{
+  std::ios_base::fmtflags flags = os.flags();
+  int base = 10;
+  if ((flags & std::ios_base::basefield) == std::ios_base::hex)
+    base = 16;
+  else if ((flags & std::ios_base::basefield) == std::ios_base::oct)
+    base = 8;
+
+  std::string digits = i.toString(base);
+  if (base != 10 && (flags & std::ios_base::showbase) && !i.isZero())
   {
-    os << std::setw(2) << std::setfill('0')
-       << static_cast<int>(i.digits[j]);
+    size_t at = i.sign ? 1 : 0;
+    digits.insert(at, base == 16 ? "0x" : "0");
   }
-  os << std::setfill(' ');
-  return os;
+  if (flags & std::ios_base::uppercase)
+    std::transform(digits.begin(), digits.end(), digits.begin(),
+                   [](char c) {
+                     return c >= 'a' && c <= 'z'
+                              ? static_cast<char>(c - 'a' + 'A') : c;
+                   });
+  return os << digits;
 }
 
 // ---------------------------------------------------------
@@ -255,90 +321,462 @@ Integer Integer::operator-() const
 }
 
 // ---------------------------------------------------------
-// operator+
-// Addition with sign handling.
+// addSigned(a,b,negateB)
+// Addition with sign handling; b's sign is flipped when
+// negateB is set, so subtraction never copies b.
 // ---------------------------------------------------------
-Integer Integer::operator+(const Integer &rhs) const
+Integer Integer::addSigned(const Integer &a, const Integer &b,
+                           bool negateB)
 {
-  if (sign == rhs.sign)
+  INTEGER_STATS_SCOPE(negateB ? stats::Op::IntegerSub : stats::Op::IntegerAdd,
+                      std::max(a.limbs.size(), b.limbs.size()));
+  bool bsign = b.sign != negateB;
+  if (a.isWord() && b.isWord())
+  {
+    // Both magnitudes fit a limb: at most one carry to handle.
+    Limb x = a.word(), y = b.word();
+    if (a.sign == bsign)
+    {
+      Limb s;
+      bool carry = __builtin_add_overflow(x, y, &s);
+      return fromWords(a.sign, s, carry);
+    }
+    return x >= y ? fromWords(a.sign, x - y) : fromWords(bsign, y - x);
+  }
+
+  if (a.sign == bsign)
   {
-    Integer r = addMagnitude(*this, rhs);
-    r.sign = sign;
+    Integer r = addMagnitude(a, b);
+    r.sign = a.sign;
     r.normalize();
     return r;
   }
 
-  int cmp = compareMagnitude(*this, rhs);
+  int cmp = compareMagnitude(a, b);
   if (cmp == 0)
     return Integer();
   if (cmp > 0)
   {
-    Integer r = subtractMagnitude(*this, rhs);
-    r.sign = sign;
+    Integer r = subtractMagnitude(a, b);
+    r.sign = a.sign;
     r.normalize();
     return r;
   }
-  Integer r = subtractMagnitude(rhs, *this);
-  r.sign = rhs.sign;
+  Integer r = subtractMagnitude(b, a);
+  r.sign = bsign;
   r.normalize();
   return r;
 }
 
 // ---------------------------------------------------------
-// operator-
-// Subtraction via addition of negation.
+// operator+, operator-
 // ---------------------------------------------------------
+Integer Integer::operator+(const Integer &rhs) const
+{
+  return addSigned(*this, rhs, false);
+}
+
 Integer Integer::operator-(const Integer &rhs) const
 {
-  return *this + (-rhs);
+  return addSigned(*this, rhs, true);
 }
 
 // ---------------------------------------------------------
-// operator*
-// Multiplication (schoolbook) with sign.
+// addInPlace(rhs,negate)
+// *this += rhs (or -= rhs). The limb kernels allow the result
+// to alias either operand, so the sum is formed directly in
+// this->limbs, which only grows when the result needs it.
 // ---------------------------------------------------------
-Integer Integer::operator*(const Integer &rhs) const
+void Integer::addInPlace(const Integer &rhs, bool negate)
 {
-  if (isZero() || rhs.isZero())
-    return Integer();
+  INTEGER_STATS_SCOPE(negate ? stats::Op::IntegerSub : stats::Op::IntegerAdd,
+                      std::max(limbs.size(), rhs.limbs.size()));
+  if (rhs.isZero())
+    return;
+
+  if (this == &rhs)
+  {
+    // x + x doubles, x - x vanishes.
+    if (negate)
+    {
+      limbs.clear();
+      sign = false;
+    }
+    else if (Limb out = limb::lshift(limbs.data(), limbs.data(),
+                                     limbs.size(), 1))
+      limbs.push_back(out);
+    return;
+  }
+
+  addLimbsInPlace(rhs.limbs.data(), rhs.limbs.size(), rhs.sign != negate);
+}
 
-  bool rs = (sign != rhs.sign);
-  size_t n1 = digits.size(), n2 = rhs.digits.size();
-  std::vector<int> tmp(n1 + n2, 0);
+// ---------------------------------------------------------
+// addLimbsInPlace(b,bn,bsign)
+// *this += (bsign ? -1 : 1) * b[0..bn).
+// Preconditions: bn > 0, b[bn-1] != 0, b not in this->limbs.
+// ---------------------------------------------------------
+void Integer::addLimbsInPlace(const Limb *b, size_t bn, bool bsign)
+{
+  size_t an = limbs.size();
+  if (an == 0)
+  {
+    limbs.assign(b, b + bn);
+    sign = bsign;
+    return;
+  }
 
-  for (size_t i = 0; i < n1; ++i)
+  if (sign == bsign)
   {
-    int carry = 0;
-    for (size_t j = 0; j < n2; ++j)
+    Limb carry;
+    if (an >= bn)
+      carry = limb::add(limbs.data(), limbs.data(), an, b, bn);
+    else
     {
-      long long v = tmp[i+j]
-        + static_cast<long long>(digits[i]) * rhs.digits[j]
-        + carry;
-      tmp[i+j] = static_cast<int>(v % BASE);
-      carry = static_cast<int>(v / BASE);
+      limbs.resize(bn);
+      carry = limb::add(limbs.data(), b, bn, limbs.data(), an);
     }
-    size_t pos = i + n2;
-    while (carry)
+    if (carry)
+      limbs.push_back(carry);
+    return;
+  }
+
+  int cmp = an != bn ? (an < bn ? -1 : 1)
+                     : limb::cmp(limbs.data(), b, an);
+  if (cmp == 0)
+  {
+    limbs.clear();
+    sign = false;
+    return;
+  }
+  if (cmp > 0)
+    limb::sub(limbs.data(), limbs.data(), an, b, bn);
+  else
+  {
+    limbs.resize(bn);
+    limb::sub(limbs.data(), b, bn, limbs.data(), an);
+    sign = bsign;
+  }
+  normalize();
+}
+
+// ---------------------------------------------------------
+// mulAddInPlace(a,b,negate)
+// *this += a*b (or -= a*b). Below the Karatsuba threshold,
+// when the result cannot change sign, the rows a*b[i] are
+// added or subtracted straight into this->limbs: no product
+// buffer and a single normalization. Otherwise the product is
+// formed in pooled scratch and added in place.
+// ---------------------------------------------------------
+namespace
+{
+  // r[0..n) += c, stopping as soon as the carry dies out.
+  void carryInto(Limb *r, size_t n, Limb c)
+  {
+    for (size_t i = 0; c != 0 && i < n; ++i)
     {
-      long long v = tmp[pos] + carry;
-      tmp[pos] = static_cast<int>(v % BASE);
-      carry = static_cast<int>(v / BASE);
-      ++pos;
+      r[i] += c;
+      c = r[i] < c;
     }
   }
 
-  std::vector<DigitType> fd;
-  size_t m = tmp.size();
-  while (m > 1 && tmp[m-1] == 0)
-    --m;
-  if (m > 0)
+  // r[0..n) -= c, stopping as soon as the borrow dies out.
+  void borrowFrom(Limb *r, size_t n, Limb c)
+  {
+    for (size_t i = 0; c != 0 && i < n; ++i)
+    {
+      Limb x = r[i];
+      r[i] = x - c;
+      c = x < c;
+    }
+  }
+}
+
+void Integer::mulAddInPlace(const Integer &a, const Integer &b, bool negate)
+{
+  INTEGER_STATS_SCOPE(stats::Op::IntegerMul,
+                      std::max(a.limbs.size(), b.limbs.size()));
+  if (a.isZero() || b.isZero())
+    return;
+  bool psign = (a.sign != b.sign) != negate;
+  if (a.isWord() && b.isWord())
+  {
+    // The product fits two limbs on the stack; no aliasing
+    // concern either.
+    DoubleLimb p = static_cast<DoubleLimb>(a.word()) * b.word();
+    Limb w[2] = {static_cast<Limb>(p), static_cast<Limb>(p >> 64)};
+    addLimbsInPlace(w, w[1] ? 2 : 1, psign);
+    return;
+  }
+  if (this == &a || this == &b)
+  {
+    addInPlace(a * b, negate);
+    return;
+  }
+
+  const auto &big = a.limbs.size() >= b.limbs.size() ? a.limbs : b.limbs;
+  const auto &small = a.limbs.size() >= b.limbs.size() ? b.limbs : a.limbs;
+  size_t an = big.size(), bn = small.size(), pn = an + bn;
+  size_t n = limbs.size();
+
+  if (n == 0)
+  {
+    limbs.resize(pn);
+    limb::mul(limbs.data(), big.data(), an, small.data(), bn);
+    sign = psign;
+    normalize();
+    return;
+  }
+
+  if (bn < multiplyThresholds().karatsuba && (sign == psign || n > pn))
+  {
+    if (sign == psign)
+    {
+      // One extra limb absorbs the final carry.
+      size_t rn = std::max(n, pn) + 1;
+      limbs.resize(rn);
+      for (size_t i = 0; i < bn; ++i)
+      {
+        Limb c = limb::addmul_1(limbs.data() + i, big.data(), an, small[i]);
+        carryInto(limbs.data() + i + an, rn - i - an, c);
+      }
+    }
+    else
+    {
+      // n > pn, so |*this| > |a*b| and no borrow leaves the top.
+      for (size_t i = 0; i < bn; ++i)
+      {
+        Limb c = limb::submul_1(limbs.data() + i, big.data(), an, small[i]);
+        borrowFrom(limbs.data() + i + an, n - i - an, c);
+      }
+    }
+    normalize();
+    return;
+  }
+
+  LimbVector p(pn);
+  limb::mul(p.data(), big.data(), an, small.data(), bn);
+  addLimbsInPlace(p.data(), limb::normalizedSize(p.data(), pn), psign);
+}
+
+Integer &Integer::addMul(const Integer &a, const Integer &b)
+{
+  mulAddInPlace(a, b, false);
+  return *this;
+}
+
+Integer &Integer::subMul(const Integer &a, const Integer &b)
+{
+  mulAddInPlace(a, b, true);
+  return *this;
+}
+
+void Integer::reserve(std::size_t n)
+{
+  limbs.reserve(n);
+}
+
+// ---------------------------------------------------------
+// Compound assignment operators +=, -=, *=, /=, %=
+// ---------------------------------------------------------
+Integer &Integer::operator+=(const Integer &rhs)
+{
+  addInPlace(rhs, false);
+  return *this;
+}
+
+Integer &Integer::operator-=(const Integer &rhs)
+{
+  addInPlace(rhs, true);
+  return *this;
+}
+
+Integer &Integer::operator*=(const Integer &rhs)
+{
+  // The product needs a separate buffer; move it in.
+  *this = *this * rhs;
+  return *this;
+}
+
+Integer &Integer::operator/=(const Integer &rhs)
+{
+  *this = divmod(rhs).first;
+  return *this;
+}
+
+Integer &Integer::operator%=(const Integer &rhs)
+{
+  *this = divmod(rhs).second;
+  return *this;
+}
+
+// ---------------------------------------------------------
+// Overloads for temporaries
+// Accumulate into the rvalue operand and return it.
+// ---------------------------------------------------------
+Integer operator-(Integer &&i)
+{
+  if (!i.isZero())
+    i.sign = !i.sign;
+  return std::move(i);
+}
+
+Integer operator+(Integer &&a, const Integer &b)
+{
+  a += b;
+  return std::move(a);
+}
+
+Integer operator+(const Integer &a, Integer &&b)
+{
+  b += a;
+  return std::move(b);
+}
+
+Integer operator+(Integer &&a, Integer &&b)
+{
+  a += b;
+  return std::move(a);
+}
+
+Integer operator-(Integer &&a, const Integer &b)
+{
+  a -= b;
+  return std::move(a);
+}
+
+Integer operator-(const Integer &a, Integer &&b)
+{
+  // a - b == -(b - a)
+  b -= a;
+  return -std::move(b);
+}
+
+Integer operator-(Integer &&a, Integer &&b)
+{
+  a -= b;
+  return std::move(a);
+}
+
+// ---------------------------------------------------------
+// operator*
+// Multiplication with sign; the algorithm is chosen by
+// limb::mul from the operand sizes.
+// ---------------------------------------------------------
+Integer Integer::operator*(const Integer &rhs) const
+{
+  if (this == &rhs)
+    return square();
+  INTEGER_STATS_SCOPE(stats::Op::IntegerMul,
+                      std::max(limbs.size(), rhs.limbs.size()));
+  if (isZero() || rhs.isZero())
+    return Integer();
+
+  if (isWord() && rhs.isWord())
+  {
+    Limb lo;
+    if (!__builtin_mul_overflow(word(), rhs.word(), &lo))
+      return fromWords(sign != rhs.sign, lo);
+    DoubleLimb p = static_cast<DoubleLimb>(word()) * rhs.word();
+    return fromWords(sign != rhs.sign, static_cast<Limb>(p),
+                     static_cast<Limb>(p >> 64));
+  }
+
+  const auto &big = limbs.size() >= rhs.limbs.size() ? limbs : rhs.limbs;
+  const auto &small = limbs.size() >= rhs.limbs.size() ? rhs.limbs : limbs;
+
+  Integer result;
+  result.limbs.resize(big.size() + small.size());
+  limb::mul(result.limbs.data(), big.data(), big.size(),
+            small.data(), small.size());
+
+  result.sign = (sign != rhs.sign);
+  result.normalize();
+  return result;
+}
+
+// ---------------------------------------------------------
+// square()
+// Non-negative result from limb::sqr.
+// ---------------------------------------------------------
+Integer Integer::square() const
+{
+  INTEGER_STATS_SCOPE(stats::Op::IntegerMul, limbs.size());
+  if (isZero())
+    return Integer();
+  if (isWord())
+  {
+    DoubleLimb p = static_cast<DoubleLimb>(word()) * word();
+    return fromWords(false, static_cast<Limb>(p),
+                     static_cast<Limb>(p >> 64));
+  }
+
+  Integer result;
+  result.limbs.resize(2 * limbs.size());
+  limb::sqr(result.limbs.data(), limbs.data(), limbs.size());
+  result.normalize();
+  return result;
+}
+
+// ---------------------------------------------------------
+// divmod
+// Truncating division; the remainder takes the dividend's sign.
+// Preconditions: rhs != 0, else std::domain_error.
+// ---------------------------------------------------------
+std::pair<Integer, Integer> Integer::divmod(const Integer &rhs) const
+{
+  if (rhs.isZero())
+    throw std::domain_error("Integer division by zero");
+  INTEGER_STATS_SCOPE(stats::Op::IntegerDiv, limbs.size());
+
+  if (compareMagnitude(*this, rhs) < 0)
+    return {Integer(), *this};
+
+  size_t an = limbs.size(), dn = rhs.limbs.size();
+  Integer q, r;
+  if (an <= 2)
   {
-    fd.reserve(m);
-    for (size_t k = 0; k < m; ++k)
-      fd.push_back(static_cast<DigitType>(tmp[k]));
+    // Word-sized operands: divide in 128-bit arithmetic.
+    auto join = [](const LimbVector &v) {
+      DoubleLimb x = v[0];
+      if (v.size() > 1)
+        x |= static_cast<DoubleLimb>(v[1]) << 64;
+      return x;
+    };
+    DoubleLimb x = join(limbs), y = join(rhs.limbs);
+    DoubleLimb qq = x / y, rr = x % y;
+    q.limbs.push_back(static_cast<Limb>(qq));
+    q.limbs.push_back(static_cast<Limb>(qq >> 64));
+    r.limbs.push_back(static_cast<Limb>(rr));
+    r.limbs.push_back(static_cast<Limb>(rr >> 64));
   }
+  else
+  {
+    q.limbs.resize(an - dn + 1);
+    r.limbs.resize(dn);
+    limb::divrem(q.limbs.data(), r.limbs.data(), limbs.data(), an,
+                 rhs.limbs.data(), dn);
+  }
+
+  q.sign = (sign != rhs.sign);
+  r.sign = sign;
+  q.normalize();
+  r.normalize();
+  return {std::move(q), std::move(r)};
+}
+
+// ---------------------------------------------------------
+// operator/, operator%
+// Thin wrappers around divmod.
+// ---------------------------------------------------------
+Integer Integer::operator/(const Integer &rhs) const
+{
+  return divmod(rhs).first;
+}
 
-  return Integer(rs, std::move(fd));
+Integer Integer::operator%(const Integer &rhs) const
+{
+  return divmod(rhs).second;
 }
 
 // ---------------------------------------------------------
@@ -350,7 +788,7 @@ bool Integer::operator==(const Integer &rhs) const
     return true;
   if (sign != rhs.sign)
     return false;
-  return digits == rhs.digits;
+  return limbs == rhs.limbs;
 }
 
 bool Integer::operator!=(const Integer &rhs) const
@@ -375,13 +813,180 @@ bool Integer::operator>=(const Integer &rhs) const
 { return !(*this < rhs); }
 
 // ---------------------------------------------------------
-// isZero, isNegative, signum, abs
+// isZero, isNegative, limbCount, signum, abs
 // ---------------------------------------------------------
-bool Integer::isZero() const  { return digits.empty(); }
+bool Integer::isZero() const  { return limbs.empty(); }
 bool Integer::isNegative() const { return sign && !isZero(); }
+size_t Integer::limbCount() const { return limbs.size(); }
 
 int Integer::signum() const
 { return isZero() ? 0 : (sign ? -1 : 1); }
 
 Integer Integer::abs() const
-{ return sign ? -(*this) : *this; }
\ No newline at end of file
+{ return sign ? -(*this) : *this; }
+
+// ---------------------------------------------------------
+// fitsLongLong, toLongLong
+// Range is [-2^63, 2^63 - 1].
+// ---------------------------------------------------------
+bool Integer::fitsLongLong() const
+{
+  if (!isWord())
+    return false;
+  Limb limit = static_cast<Limb>(1) << 63;
+  return sign ? word() <= limit : word() < limit;
+}
+
+long long Integer::toLongLong() const
+{
+  // Negate in unsigned arithmetic so -2^63 is handled too.
+  Limb w = sign ? 0 - word() : word();
+  return static_cast<long long>(w);
+}
+
+// ---------------------------------------------------------
+// toDouble, fromDouble
+// The leading 64 bits round to 53 by their low 11 bits; the
+// bits below them only matter when those are exactly one
+// half, 0x400. Then a set lower bit is folded into bit 0
+// (rounding to odd), and the hardware conversion of the word
+// rounds to nearest-even as the whole magnitude would. ldexp
+// applies the exponent exactly, overflowing to infinity.
+// ---------------------------------------------------------
+double Integer::toDouble() const
+{
+  if (isZero())
+    return 0.0;
+  size_t n = limbs.size();
+  Limb top = topBits();
+  if (n > 1 && (top & 0x7FF) == 0x400)
+  {
+    // The top 64 bits take all of the highest limb and the
+    // high z bits of the next one.
+    unsigned z = __builtin_clzll(limbs[n-1]);
+    bool sticky = (limbs[n-2] << z) != 0;
+    for (size_t i = 0; i + 2 < n && !sticky; ++i)
+      sticky = limbs[i] != 0;
+    top |= sticky;
+  }
+  // Anything past 2^2000 overflows just the same.
+  int length = static_cast<int>(std::min<size_t>(bitLength(), 2000));
+  double d = std::ldexp(static_cast<double>(top), length - 64);
+  return sign ? -d : d;
+}
+
+Integer Integer::fromDouble(double d)
+{
+  if (!std::isfinite(d))
+    throw std::invalid_argument("Integer::fromDouble: not a finite value");
+  d = std::trunc(d);
+  if (d == 0)
+    return Integer();
+
+  // |d| = m * 2^(e-53) with a 53-bit integer m.
+  int e;
+  double f = std::frexp(std::fabs(d), &e);
+  Integer r(static_cast<long long>(std::ldexp(f, 53)));
+  if (e >= 53)
+    r <<= static_cast<size_t>(e - 53);
+  else
+    r >>= static_cast<size_t>(53 - e);
+  r.sign = d < 0;
+  return r;
+}
+
+// ---------------------------------------------------------
+// gcd(a,b)
+// Non-negative greatest common divisor via limb::gcd.
+// ---------------------------------------------------------
+Integer Integer::gcd(const Integer &a, const Integer &b)
+{
+  INTEGER_STATS_SCOPE(stats::Op::IntegerGcd,
+                      std::max(a.limbs.size(), b.limbs.size()));
+  if (a.isZero())
+    return b.abs();
+  if (b.isZero())
+    return a.abs();
+
+  Integer g;
+  g.limbs.resize(std::min(a.limbs.size(), b.limbs.size()));
+  size_t gn = limb::gcd(g.limbs.data(), a.limbs.data(), a.limbs.size(),
+                        b.limbs.data(), b.limbs.size());
+  g.limbs.resize(gn);
+  g.normalize();
+  return g;
+}
+
+// ---------------------------------------------------------
+// product(first,last), sum(first,last)
+// Balanced trees over the range (limb::reduceTree); short
+// runs at the leaves are folded left to right. The pool is
+// entered once for the whole range, so nested products share
+// it with the tree.
+// ---------------------------------------------------------
+namespace
+{
+  const std::size_t productLeaf = 16;
+  const std::size_t sumLeaf = 64;
+
+  std::size_t weight(const Integer &x)
+  {
+    return x.limbCount();
+  }
+
+  std::size_t totalWeight(const Integer *first, std::size_t n)
+  {
+    std::size_t size = 0;
+    for (std::size_t i = 0; i < n; ++i)
+      size += weight(first[i]);
+    return size;
+  }
+}
+
+Integer Integer::product(const Integer *first, const Integer *last)
+{
+  std::size_t n = static_cast<std::size_t>(last - first);
+  if (n == 0)
+    return Integer(1LL);
+  limb::ParallelScope scope(totalWeight(first, n));
+  return limb::reduceTree(
+    first, n, productLeaf,
+    [](const Integer *p, std::size_t k) {
+      Integer r = p[0];
+      for (std::size_t i = 1; i < k; ++i)
+        r *= p[i];
+      return r;
+    },
+    [](Integer x, Integer y) { return x * y; }, weight);
+}
+
+Integer Integer::product(const std::vector<Integer> &values)
+{
+  return product(values.data(), values.data() + values.size());
+}
+
+Integer Integer::sum(const Integer *first, const Integer *last)
+{
+  std::size_t n = static_cast<std::size_t>(last - first);
+  if (n == 0)
+    return Integer();
+  limb::ParallelScope scope(totalWeight(first, n));
+  return limb::reduceTree(
+    first, n, sumLeaf,
+    [](const Integer *p, std::size_t k) {
+      Integer r = p[0];
+      for (std::size_t i = 1; i < k; ++i)
+        r += p[i];
+      return r;
+    },
+    [](Integer x, Integer y) {
+      x += y;
+      return x;
+    },
+    weight);
+}
+
+Integer Integer::sum(const std::vector<Integer> &values)
+{
+  return sum(values.data(), values.data() + values.size());
+}
@@ -4,16 +4,21 @@
  * signed integers with basic arithmetic and comparison operations.
  *
  * Author: Abdoulie Jallow <Jallow.jku@gmail.com>
- * Last Modification: 23/04/2025
+ * Last Modification: 16/10/2026
  *
  **************************************************************************/
 
 #ifndef INTEGER_H
 #define INTEGER_H
 
+#include "LimbVector.h"
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <utility>
 
 /***************************************************************************
  * The Integer class represents signed arbitrary-precision integers.
@@ -22,12 +27,23 @@
  **************************************************************************/
 class Integer
 {
+public:
+    // A single machine-word digit (limb) of the magnitude, base 2^64.
+    using Limb = std::uint64_t;
+
 private:
     // Indicates the sign of the integer: false for non-negative, true for negative.
     bool sign = false;
 
-    // Stores the digits of the integer in base 100, least significant digit first.
-    std::vector<unsigned char> digits = {};
+    // Stores the magnitude in base 2^64, least significant limb first.
+    // Up to LimbVector::inlineCapacity limbs are kept without a heap
+    // allocation.
+    LimbVector limbs;
+
+    // Modulus (Modulus.h) and IntegerView (IntegerView.h) work on the limbs
+    // of their operands directly.
+    friend class Modulus;
+    friend class IntegerView;
 
     /*************************************************************************
      * normalize()
@@ -51,6 +67,36 @@ private:
     // Compares the magnitudes of two integers.
     static int compareMagnitude(const Integer &a, const Integer &b);
 
+    // True if the magnitude fits in a single limb (the word-sized fast
+    // paths of +, - and * apply).
+    bool isWord() const;
+
+    // Magnitude of a word-sized integer.
+    Limb word() const;
+
+    // Builds the integer with the given sign and a magnitude of up to
+    // two limbs (hi:lo).
+    static Integer fromWords(bool negative, Limb lo, Limb hi = 0);
+
+    // Returns a + b, or a - b when negateB is set.
+    static Integer addSigned(const Integer &a, const Integer &b,
+                             bool negateB);
+
+    // In-place *this += i (or -= i when negate is set), reusing the limb
+    // buffer of *this.
+    void addInPlace(const Integer &i, bool negate);
+
+    // In-place *this += b (or -= b when bsign is set) for a normalized,
+    // non-zero magnitude b[0..bn) outside this->limbs.
+    void addLimbsInPlace(const Limb *b, std::size_t bn, bool bsign);
+
+    // In-place *this += a * b (or -= a * b when negate is set).
+    void mulAddInPlace(const Integer &a, const Integer &b, bool negate);
+
+    // Returns a & b, a | b or a ^ b for op '&', '|' or '^', on the
+    // two's-complement forms of a and b.
+    static Integer bitwise(const Integer &a, const Integer &b, char op);
+
 public:
     /*************************************************************************
      * Constructors.
@@ -62,19 +108,35 @@ public:
     // Constructs an integer from a built-in integer.
     Integer(long long i);
 
-    // Constructs an integer from a sign and a C-style array of digits.
+    // Constructs an integer from a sign and a C-style array of base-100
+    // digits, least significant digit first.
     Integer(bool s, int n, const char *d);
 
-    // Constructs an integer from a sign and a vector of digits.
+    // Constructs an integer from a sign and a vector of base-100 digits,
+    // least significant digit first.
     Integer(bool s, std::vector<unsigned char> d_vec);
 
+    // Parses an optional sign followed by digits in the given base
+    // (2..36, letters in either case). A "0x" or "0b" prefix is accepted
+    // for base 16 or 2. Conversion is subquadratic in the length.
+    // Throws std::invalid_argument on an empty or malformed string or an
+    // unsupported base.
+    explicit Integer(std::string_view s, int base = 10);
+
     /*************************************************************************
      * Output operator.
      *************************************************************************/
 
-    // Outputs the integer to an output stream.
+    // Outputs the integer to an output stream in decimal, or in octal or
+    // hexadecimal when std::oct or std::hex is set (std::uppercase and
+    // std::showbase are honored).
     friend std::ostream &operator<<(std::ostream &os, const Integer &i);
 
+    // Returns the digits in the given base (2..36, lowercase letters),
+    // with a leading '-' for negative values. Throws
+    // std::invalid_argument for an unsupported base.
+    std::string toString(int base = 10) const;
+
     /*************************************************************************
      * Arithmetic operators.
      *************************************************************************/
@@ -88,9 +150,207 @@ public:
     // Binary subtraction operator.
     Integer operator-(const Integer &i) const;
 
-    // Binary multiplication operator.
+    // Binary multiplication operator. Picks schoolbook, Karatsuba, Toom-3,
+    // NTT or an unbalanced slicing strategy from multiplyThresholds().
+    // x * x (the same object on both sides) is computed as x.square().
     Integer operator*(const Integer &i) const;
 
+    // Returns *this * *this using the squaring algorithms, which need
+    // about half the schoolbook work and one transform less in NTT range.
+    Integer square() const;
+
+    // Quotient truncated toward zero, as for built-in integers.
+    // Throws std::domain_error on division by zero.
+    Integer operator/(const Integer &i) const;
+
+    // Remainder with the sign of the dividend, so that
+    // a == (a / b) * b + a % b. Throws std::domain_error if i is zero.
+    Integer operator%(const Integer &i) const;
+
+    // Returns {*this / i, *this % i} from a single division.
+    std::pair<Integer, Integer> divmod(const Integer &i) const;
+
+    /*************************************************************************
+     * Compound assignment operators.
+     * += and -= work in place and only reallocate when the result outgrows
+     * the current buffer; *=, /= and %= move the new value in.
+     *************************************************************************/
+
+    Integer &operator+=(const Integer &i);
+    Integer &operator-=(const Integer &i);
+    Integer &operator*=(const Integer &i);
+    Integer &operator/=(const Integer &i);
+    Integer &operator%=(const Integer &i);
+
+    /*************************************************************************
+     * Fused multiply-add.
+     * *this += a * b and *this -= a * b. In schoolbook range the product is
+     * accumulated row by row into the buffer of *this, without a temporary
+     * and with one normalization; larger products use recycled scratch.
+     * IntegerExpr.h builds on these to evaluate whole sums of products.
+     *************************************************************************/
+
+    Integer &addMul(const Integer &a, const Integer &b);
+    Integer &subMul(const Integer &a, const Integer &b);
+
+    // Preallocates room for a magnitude of n limbs, so that results up to
+    // that size are formed without reallocating.
+    void reserve(std::size_t n);
+
+    /*************************************************************************
+     * Overloads for temporaries.
+     * These reuse the storage of an rvalue operand instead of allocating a
+     * fresh result, so chains like a + b + c allocate at most once.
+     *************************************************************************/
+
+    friend Integer operator-(Integer &&i);
+    friend Integer operator+(Integer &&a, const Integer &b);
+    friend Integer operator+(const Integer &a, Integer &&b);
+    friend Integer operator+(Integer &&a, Integer &&b);
+    friend Integer operator-(Integer &&a, const Integer &b);
+    friend Integer operator-(const Integer &a, Integer &&b);
+    friend Integer operator-(Integer &&a, Integer &&b);
+
+    /*************************************************************************
+     * Products and sums of many values.
+     *************************************************************************/
+
+    // Product and sum of [first, last) (or of all values), evaluated as a
+    // balanced binary tree so both operands of every step have about the
+    // same size; subtrees of at least MultiplyThresholds::parallel limbs run
+    // on the thread pool. An empty product is 1, an empty sum 0.
+    static Integer product(const Integer *first, const Integer *last);
+    static Integer product(const std::vector<Integer> &values);
+    static Integer sum(const Integer *first, const Integer *last);
+    static Integer sum(const std::vector<Integer> &values);
+
+    /*************************************************************************
+     * Powers.
+     * Both scan the exponent with a sliding window, so a k-bit exponent
+     * takes about k squarings and k / log2(k) multiplications.
+     *************************************************************************/
+
+    // Returns base^exp; pow(x, 0) == 1, including for x == 0. Powers of two
+    // in base are split off and shifted in at the end.
+    static Integer pow(const Integer &base, std::uint64_t exp);
+
+    // Returns base^exp mod m in [0, m), reducing after every step with
+    // Montgomery multiplication for odd m and Barrett reduction otherwise.
+    // Throws std::domain_error unless m > 0 and exp >= 0. Prepares m from
+    // scratch on each call; use a Modulus (Modulus.h) to reuse it.
+    static Integer powmod(const Integer &base, const Integer &exp,
+                          const Integer &m);
+
+    /*************************************************************************
+     * Bitwise operations.
+     * &, |, ^, ~ and testBit() see a value in two's complement with
+     * infinitely many sign bits, as for built-in integers, and >> rounds
+     * toward minus infinity, so x >> n == floor(x / 2^n) and -1 >> n == -1.
+     * All of them take time linear in the limb count.
+     *************************************************************************/
+
+    // *this * 2^n and floor(*this / 2^n).
+    Integer operator<<(std::size_t n) const;
+    Integer operator>>(std::size_t n) const;
+
+    Integer operator&(const Integer &i) const;
+    Integer operator|(const Integer &i) const;
+    Integer operator^(const Integer &i) const;
+
+    // -*this - 1.
+    Integer operator~() const;
+
+    Integer &operator<<=(std::size_t n);
+    Integer &operator>>=(std::size_t n);
+    Integer &operator&=(const Integer &i);
+    Integer &operator|=(const Integer &i);
+    Integer &operator^=(const Integer &i);
+
+    // Bits in the magnitude, without leading zeros (0 for zero).
+    std::size_t bitLength() const;
+
+    // The leading 64 bits of the magnitude, shifted so that bit 63 is set:
+    // |x| >> (bitLength() - 64), or |x| << (64 - bitLength()) for short
+    // values; 0 for zero. Reads at most the top two limbs, so
+    // topBits() * 2^(bitLength() - 64) approximates |x| from below to 64
+    // bits in constant time.
+    Limb topBits() const;
+
+    // Set bits in the magnitude.
+    std::size_t popCount() const;
+
+    // Bit n of the two's-complement form; true for every n at or above
+    // bitLength() when the value is negative.
+    bool testBit(std::size_t n) const;
+
+    /*************************************************************************
+     * Algorithm tuning.
+     *************************************************************************/
+
+    // Operand sizes, in limbs of the shorter operand, at which operator*
+    // changes algorithm.
+    struct MultiplyThresholds
+    {
+        // Schoolbook below this size, Karatsuba from here on.
+        std::size_t karatsuba = 32;
+
+        // Toom-3 from this size on (for roughly balanced operands).
+        std::size_t toom3 = 160;
+
+        // Number-theoretic transform from this size on.
+        std::size_t ntt = 3000;
+
+        // From this size on the NTT, the Karatsuba/Toom-3 branches, the
+        // unbalanced slices and the subtrees of product() and sum() run on
+        // a shared work-stealing thread pool.
+        std::size_t parallel = 8000;
+
+        // The same crossovers for squares (square(), x * x), whose
+        // schoolbook kernel forms each cross product only once.
+        std::size_t squareKaratsuba = 48;
+        std::size_t squareToom3 = 250;
+        std::size_t squareNtt = 6000;
+
+        // Threads used for parallel products, including the caller;
+        // 0 means std::thread::hardware_concurrency(), 1 disables them.
+        std::size_t threads = 0;
+    };
+
+    // Returns the process-wide thresholds; assign to tune per machine.
+    // Not synchronized: adjust before multiplying on other threads.
+    // Products themselves may run concurrently from any number of threads.
+    static MultiplyThresholds &multiplyThresholds();
+
+    // Divisor sizes, in limbs, at which division changes algorithm.
+    struct DivideThresholds
+    {
+        // Knuth's Algorithm D below this size, recursive
+        // divide-and-conquer division from here on.
+        std::size_t divideAndConquer = 60;
+
+        // Newton reciprocal and Barrett division once both the divisor
+        // and the quotient reach this size.
+        std::size_t newton = 10000;
+    };
+
+    // Returns the process-wide division thresholds; same caveats as
+    // multiplyThresholds().
+    static DivideThresholds &divideThresholds();
+
+    // Operand sizes, in limbs, at which gcd() changes algorithm.
+    struct GcdThresholds
+    {
+        // Lehmer's algorithm below this size, half-GCD from here on.
+        std::size_t halfGcd = 360;
+
+        // Inside half-GCD, recursion bottoms out below this size.
+        std::size_t halfGcdBasecase = 120;
+    };
+
+    // Returns the process-wide GCD thresholds; same caveats as
+    // multiplyThresholds().
+    static GcdThresholds &gcdThresholds();
+
     /*************************************************************************
      * Comparison operators.
      *************************************************************************/
@@ -112,11 +372,32 @@ public:
     // Checks if the integer is negative.
     bool isNegative() const;
 
+    // Returns the number of 64-bit limbs in the magnitude (0 for zero).
+    std::size_t limbCount() const;
+
     // Returns the sign of the integer (-1 for negative, 0 for zero, 1 for positive).
     int signum() const;
 
     // Returns the absolute value of the integer.
     Integer abs() const;
+
+    // Checks if the value is representable as a long long.
+    bool fitsLongLong() const;
+
+    // Returns the value as a long long. Input condition: fitsLongLong().
+    long long toLongLong() const;
+
+    // Returns the nearest double (ties to even), +-infinity past the
+    // largest finite one. Reads only the leading limbs and, if those leave
+    // it undecided, whether any lower bit is set.
+    double toDouble() const;
+
+    // Returns d truncated toward zero, so the value is exact for integral
+    // d. Throws std::invalid_argument if d is infinite or NaN.
+    static Integer fromDouble(double d);
+
+    // Returns the non-negative greatest common divisor; gcd(0, 0) == 0.
+    static Integer gcd(const Integer &a, const Integer &b);
 };
 
 #endif // INTEGER_H
@@ -0,0 +1,263 @@
+// ---------------------------------------------------------
+// File: IntegerBatch.cpp
+// Word columns, spilling and the element-wise operations of
+// IntegerBatch and RationalBatch.
+//
+// Author: agent <agent@local>
+// Last Modification: 2026-10-16
+//
+// An operation first runs the whole column through a kernel
+// and only then visits the lanes the kernel marked, so a batch
+// without spills or overflows never leaves the fast loop.
+// ---------------------------------------------------------
+
+#include "IntegerBatch.h"
+#include "Limb.h"
+#include <stdexcept>  // for std::invalid_argument
+
+namespace
+{
+  void checkSizes(std::size_t an, std::size_t bn)
+  {
+    if (an != bn)
+      throw std::invalid_argument("element-wise operands differ in size");
+  }
+
+  int sign(bool less, bool greater)
+  {
+    return static_cast<int>(greater) - static_cast<int>(less);
+  }
+}
+
+// ---------------------------------------------------------
+// IntegerBatch
+// ---------------------------------------------------------
+IntegerBatch::IntegerBatch(std::size_t n)
+  : words(n, 0)
+{
+}
+
+IntegerBatch::IntegerBatch(const std::vector<Integer> &values)
+{
+  words.reserve(values.size());
+  for (const Integer &x : values)
+    append(x);
+}
+
+void IntegerBatch::append(const Integer &x)
+{
+  words.push_back(0);
+  set(words.size() - 1, x);
+}
+
+void IntegerBatch::append(long long x)
+{
+  if (x == spillMark)
+    append(Integer(x));
+  else
+    words.push_back(x);
+}
+
+Integer IntegerBatch::operator[](std::size_t i) const
+{
+  if (words[i] != spillMark)
+    return Integer(words[i]);
+  return spill.at(i);
+}
+
+void IntegerBatch::set(std::size_t i, const Integer &x)
+{
+  if (x.fitsLongLong() && x.toLongLong() != spillMark)
+  {
+    if (words[i] == spillMark)
+      spill.erase(i);
+    words[i] = x.toLongLong();
+    return;
+  }
+  words[i] = spillMark;
+  spill[i] = x;
+}
+
+std::vector<Integer> IntegerBatch::toVector() const
+{
+  std::vector<Integer> values;
+  values.reserve(size());
+  for (std::size_t i = 0; i < size(); ++i)
+    values.push_back((*this)[i]);
+  return values;
+}
+
+// ---------------------------------------------------------
+// combine(a,b,op)
+// Marked product lanes are first retried in words: the
+// vector kernels mark every lane with an operand beyond 32
+// bits.
+// ---------------------------------------------------------
+IntegerBatch IntegerBatch::combine(const IntegerBatch &a,
+                                   const IntegerBatch &b, char op)
+{
+  static_assert(spillMark == limb::wordMark, "lane markers differ");
+  checkSizes(a.size(), b.size());
+  std::size_t n = a.size();
+  IntegerBatch r;
+  r.words.resize(n);
+  const long long *x = a.words.data(), *y = b.words.data();
+  long long *z = r.words.data();
+  std::size_t marked = op == '+'   ? limb::add_words(z, x, y, n)
+                       : op == '-' ? limb::sub_words(z, x, y, n)
+                                   : limb::mul_words(z, x, y, n);
+
+  for (std::size_t i = 0; marked > 0; ++i)
+  {
+    if (z[i] != spillMark)
+      continue;
+    --marked;
+    long long p;
+    if (op == '*' && x[i] != spillMark && y[i] != spillMark
+        && !__builtin_mul_overflow(x[i], y[i], &p) && p != spillMark)
+    {
+      z[i] = p;
+      continue;
+    }
+    Integer u = a[i], v = b[i];
+    r.set(i, op == '+' ? u + v : op == '-' ? u - v : u * v);
+  }
+  return r;
+}
+
+std::vector<signed char> IntegerBatch::compare(const IntegerBatch &a,
+                                               const IntegerBatch &b)
+{
+  checkSizes(a.size(), b.size());
+  std::size_t n = a.size();
+  std::vector<signed char> r(n);
+  std::size_t marked = limb::cmp_words(r.data(), a.words.data(),
+                                       b.words.data(), n);
+  for (std::size_t i = 0; marked > 0; ++i)
+  {
+    if (a.words[i] != spillMark && b.words[i] != spillMark)
+      continue;
+    --marked;
+    Integer u = a[i], v = b[i];
+    r[i] = static_cast<signed char>(sign(u < v, u > v));
+  }
+  return r;
+}
+
+// ---------------------------------------------------------
+// RationalBatch
+// ---------------------------------------------------------
+RationalBatch::RationalBatch(std::size_t n)
+  : nums(n, 0), dens(n, 1)
+{
+}
+
+RationalBatch::RationalBatch(const std::vector<Rational> &values)
+{
+  reserve(values.size());
+  for (const Rational &x : values)
+    append(x);
+}
+
+void RationalBatch::reserve(std::size_t n)
+{
+  nums.reserve(n);
+  dens.reserve(n);
+}
+
+void RationalBatch::append(const Rational &x)
+{
+  nums.push_back(0);
+  dens.push_back(1);
+  set(nums.size() - 1, x);
+}
+
+Rational RationalBatch::operator[](std::size_t i) const
+{
+  if (dens[i] != 0)
+    return Rational::fromReduced(Integer(nums[i]), Integer(dens[i]));
+  return spill.at(i);
+}
+
+void RationalBatch::set(std::size_t i, const Rational &x)
+{
+  const Integer &n = x.numerator(), &d = x.denominator();
+  if (n.fitsLongLong() && n.toLongLong() != LLONG_MIN && d.fitsLongLong())
+  {
+    if (dens[i] == 0)
+      spill.erase(i);
+    nums[i] = n.toLongLong();
+    dens[i] = d.toLongLong();
+    return;
+  }
+  nums[i] = 0;
+  dens[i] = 0;
+  spill[i] = x;
+}
+
+std::vector<Rational> RationalBatch::toVector() const
+{
+  std::vector<Rational> values;
+  values.reserve(size());
+  for (std::size_t i = 0; i < size(); ++i)
+    values.push_back((*this)[i]);
+  return values;
+}
+
+// ---------------------------------------------------------
+// combine(a,b,op)
+// Each lane needs its own gcds, so lanes run one at a time,
+// but straight from the columns and without allocating.
+// ---------------------------------------------------------
+RationalBatch RationalBatch::combine(const RationalBatch &a,
+                                     const RationalBatch &b, char op)
+{
+  checkSizes(a.size(), b.size());
+  std::size_t size = a.size();
+  RationalBatch r(size);
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    long long an = a.nums[i], ad = a.dens[i];
+    long long bn = b.nums[i], bd = b.dens[i];
+    long long n = 0, d = 1;
+    bool ok = ad != 0 && bd != 0;
+    if (ok && op == '*')
+      ok = an == 0 || bn == 0
+           || (Rational::multiplyWords(an, ad, bn, bd, n, d)
+               && n != LLONG_MIN);
+    else if (ok)
+      ok = Rational::addWords(an, ad, bn, bd, op == '-', n, d);
+
+    if (ok)
+    {
+      r.nums[i] = n;
+      r.dens[i] = d;
+      continue;
+    }
+    Rational u = a[i], v = b[i];
+    r.set(i, op == '+' ? u + v : op == '-' ? u - v : u * v);
+  }
+  return r;
+}
+
+std::vector<signed char> RationalBatch::compare(const RationalBatch &a,
+                                                const RationalBatch &b)
+{
+  checkSizes(a.size(), b.size());
+  std::size_t n = a.size();
+  std::vector<signed char> r(n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    if (a.dens[i] != 0 && b.dens[i] != 0)
+    {
+      __int128 x = static_cast<__int128>(a.nums[i]) * b.dens[i];
+      __int128 y = static_cast<__int128>(b.nums[i]) * a.dens[i];
+      r[i] = static_cast<signed char>(sign(x < y, x > y));
+    }
+    else
+    {
+      r[i] = static_cast<signed char>(a[i].compare(b[i]));
+    }
+  }
+  return r;
+}
@@ -0,0 +1,164 @@
+// ---------------------------------------------------------
+// File: IntegerBatch.h
+// Structure-of-arrays containers for many small Integers and
+// Rationals, with element-wise arithmetic.
+//
+// Author: agent <agent@local>
+// Last Modification: 2026-10-16
+//
+// A std::vector<Integer> keeps every value behind its own
+// object, so element-wise work walks one Integer at a time. A
+// batch keeps the values that fit in a long long in one
+// contiguous column instead and runs whole columns through
+// the word lane kernels, several lanes per AVX2 or AVX-512
+// instruction. A value that does not fit (or that an
+// operation overflows into) spills to an ordinary Integer or
+// Rational on the side; its lane holds a marker.
+// ---------------------------------------------------------
+
+#ifndef INTEGER_BATCH_H
+#define INTEGER_BATCH_H
+
+#include "Integer.h"
+#include "Rational.h"
+#include <climits>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+// ---------------------------------------------------------
+// Class: IntegerBatch
+// A sequence of Integers. Element-wise operators take two
+// batches of the same size (std::invalid_argument otherwise)
+// and return a new batch; lanes that overflow are recomputed
+// with Integer arithmetic.
+// ---------------------------------------------------------
+class IntegerBatch
+{
+public:
+    IntegerBatch() = default;
+
+    // n zeros.
+    explicit IntegerBatch(std::size_t n);
+
+    explicit IntegerBatch(const std::vector<Integer> &values);
+
+    std::size_t size() const { return words.size(); }
+    void reserve(std::size_t n) { words.reserve(n); }
+
+    void append(const Integer &x);
+    void append(long long x);
+
+    // Element i as an Integer. Preconditions: i < size().
+    Integer operator[](std::size_t i) const;
+
+    // Replaces element i. Preconditions: i < size().
+    void set(std::size_t i, const Integer &x);
+
+    // True if element i is held in the word column.
+    bool isWord(std::size_t i) const { return words[i] != spillMark; }
+
+    // Number of elements held as Integers.
+    std::size_t spillCount() const { return spill.size(); }
+
+    std::vector<Integer> toVector() const;
+
+    // -------------------------------------------------------
+    // Arithmetic operators +, -, *
+    // -------------------------------------------------------
+    friend IntegerBatch operator+(const IntegerBatch &a, const IntegerBatch &b)
+    { return combine(a, b, '+'); }
+    friend IntegerBatch operator-(const IntegerBatch &a, const IntegerBatch &b)
+    { return combine(a, b, '-'); }
+    friend IntegerBatch operator*(const IntegerBatch &a, const IntegerBatch &b)
+    { return combine(a, b, '*'); }
+
+    // -------------------------------------------------------
+    // compare(a,b)
+    // Element i of the result is -1, 0 or 1 as a[i] is less
+    // than, equal to or greater than b[i].
+    // -------------------------------------------------------
+    static std::vector<signed char> compare(const IntegerBatch &a,
+                                            const IntegerBatch &b);
+
+private:
+    // Lane value of a spilled element; LLONG_MIN itself spills.
+    static constexpr long long spillMark = LLONG_MIN;
+
+    static IntegerBatch combine(const IntegerBatch &a, const IntegerBatch &b,
+                                char op);
+
+    std::vector<long long> words;
+    std::unordered_map<std::size_t, Integer> spill;
+};
+
+// ---------------------------------------------------------
+// Class: RationalBatch
+// A sequence of Rationals in lowest terms, numerators and
+// denominators in separate word columns. Lanes go through the
+// overflow-checked word paths of Rational arithmetic; a lane
+// that overflows is recomputed with Rational and spills.
+// Element-wise operators take batches of the same size
+// (std::invalid_argument otherwise).
+// ---------------------------------------------------------
+class RationalBatch
+{
+public:
+    RationalBatch() = default;
+
+    // n zeros.
+    explicit RationalBatch(std::size_t n);
+
+    explicit RationalBatch(const std::vector<Rational> &values);
+
+    std::size_t size() const { return nums.size(); }
+    void reserve(std::size_t n);
+
+    void append(const Rational &x);
+
+    // Element i as a Rational. Preconditions: i < size().
+    Rational operator[](std::size_t i) const;
+
+    // Replaces element i. Preconditions: i < size().
+    void set(std::size_t i, const Rational &x);
+
+    // True if element i is held in the word columns.
+    bool isWord(std::size_t i) const { return dens[i] != 0; }
+
+    // Number of elements held as Rationals.
+    std::size_t spillCount() const { return spill.size(); }
+
+    std::vector<Rational> toVector() const;
+
+    // -------------------------------------------------------
+    // Arithmetic operators +, -, *
+    // -------------------------------------------------------
+    friend RationalBatch operator+(const RationalBatch &a,
+                                   const RationalBatch &b)
+    { return combine(a, b, '+'); }
+    friend RationalBatch operator-(const RationalBatch &a,
+                                   const RationalBatch &b)
+    { return combine(a, b, '-'); }
+    friend RationalBatch operator*(const RationalBatch &a,
+                                   const RationalBatch &b)
+    { return combine(a, b, '*'); }
+
+    // -------------------------------------------------------
+    // compare(a,b)
+    // As IntegerBatch::compare. Word lanes compare exactly by
+    // 128-bit cross products.
+    // -------------------------------------------------------
+    static std::vector<signed char> compare(const RationalBatch &a,
+                                            const RationalBatch &b);
+
+private:
+    static RationalBatch combine(const RationalBatch &a,
+                                 const RationalBatch &b, char op);
+
+    // A zero denominator marks a spilled element.
+    std::vector<long long> nums;
+    std::vector<long long> dens;
+    std::unordered_map<std::size_t, Rational> spill;
+};
+
+#endif // INTEGER_BATCH_H
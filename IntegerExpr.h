@@ -0,0 +1,315 @@
+// ---------------------------------------------------------
+// File: IntegerExpr.h
+// Opt-in expression templates for sums of Integer products.
+//
+// Author: agent <agent@local>
+// Last Modification: 2026-10-16
+//
+// Wrapping an operand in expr::lazy() makes +, - and * build
+// an expression tree instead of computing Integer
+// temporaries. expr::assign() or expr::eval() then walks the
+// tree once, accumulating every term into one preallocated
+// result: a product of two operands goes through the fused
+// Integer::addMul()/subMul(), a plain operand through += or
+// -=. For example
+//
+//   expr::assign(t, expr::lazy(a) * d + expr::lazy(b) * c);
+//
+// forms a*d + b*c in t's buffer without a temporary for
+// either product in schoolbook range. Only nested products,
+// such as (a + b) * c, evaluate their factors separately.
+//
+// Expressions hold references to their operands: evaluate
+// them within the full-expression that builds them and do not
+// keep them in auto variables past that point.
+// ---------------------------------------------------------
+
+#ifndef INTEGER_EXPR_H
+#define INTEGER_EXPR_H
+
+#include "Integer.h"
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+
+namespace expr
+{
+
+// ---------------------------------------------------------
+// Expression nodes
+// ---------------------------------------------------------
+struct Ref
+{
+    const Integer &value;
+};
+
+template <typename L, typename R>
+struct Product
+{
+    L left;
+    R right;
+};
+
+template <typename L, typename R, bool Subtract>
+struct Sum
+{
+    L left;
+    R right;
+};
+
+template <typename E>
+struct Negate
+{
+    E operand;
+};
+
+template <typename T>
+struct IsExpr : std::false_type {};
+template <>
+struct IsExpr<Ref> : std::true_type {};
+template <typename L, typename R>
+struct IsExpr<Product<L, R>> : std::true_type {};
+template <typename L, typename R, bool S>
+struct IsExpr<Sum<L, R, S>> : std::true_type {};
+template <typename E>
+struct IsExpr<Negate<E>> : std::true_type {};
+
+// -------------------------------------------------------
+// lazy(x)
+// Starts an expression; x must outlive its evaluation.
+// -------------------------------------------------------
+inline Ref lazy(const Integer &x)
+{
+    return Ref{x};
+}
+
+namespace detail
+{
+    inline Ref wrap(const Integer &x) { return Ref{x}; }
+
+    template <typename E,
+              typename = std::enable_if_t<IsExpr<E>::value>>
+    const E &wrap(const E &e)
+    {
+        return e;
+    }
+
+    template <typename T>
+    using Node = std::decay_t<decltype(wrap(std::declval<const T &>()))>;
+
+    // Operators apply when at least one side is an expression
+    // and the other is an expression or an Integer.
+    template <typename L, typename R>
+    using EnableBinary = std::enable_if_t<
+        (IsExpr<L>::value || IsExpr<R>::value)
+        && (IsExpr<L>::value || std::is_same<L, Integer>::value)
+        && (IsExpr<R>::value || std::is_same<R, Integer>::value)>;
+}
+
+template <typename L, typename R, typename = detail::EnableBinary<L, R>>
+Product<detail::Node<L>, detail::Node<R>> operator*(const L &l, const R &r)
+{
+    return {detail::wrap(l), detail::wrap(r)};
+}
+
+template <typename L, typename R, typename = detail::EnableBinary<L, R>>
+Sum<detail::Node<L>, detail::Node<R>, false> operator+(const L &l,
+                                                      const R &r)
+{
+    return {detail::wrap(l), detail::wrap(r)};
+}
+
+template <typename L, typename R, typename = detail::EnableBinary<L, R>>
+Sum<detail::Node<L>, detail::Node<R>, true> operator-(const L &l,
+                                                     const R &r)
+{
+    return {detail::wrap(l), detail::wrap(r)};
+}
+
+template <typename E, typename = std::enable_if_t<IsExpr<E>::value>>
+Negate<E> operator-(const E &e)
+{
+    return {e};
+}
+
+template <typename E>
+Integer eval(const E &e);
+
+namespace detail
+{
+    // The overloads recurse into each other, so all of them
+    // are declared before any is defined.
+    template <typename L, typename R>
+    std::size_t bound(const Product<L, R> &p);
+    template <typename L, typename R, bool S>
+    std::size_t bound(const Sum<L, R, S> &s);
+    template <typename E>
+    std::size_t bound(const Negate<E> &n);
+    template <typename L, typename R>
+    bool refersTo(const Product<L, R> &p, const Integer *x);
+    template <typename L, typename R, bool S>
+    bool refersTo(const Sum<L, R, S> &s, const Integer *x);
+    template <typename E>
+    bool refersTo(const Negate<E> &n, const Integer *x);
+    inline void accumulate(Integer &acc, const Product<Ref, Ref> &p,
+                           bool negate);
+    template <typename L, typename R>
+    void accumulate(Integer &acc, const Product<L, R> &p, bool negate);
+    template <typename L, typename R, bool S>
+    void accumulate(Integer &acc, const Sum<L, R, S> &s, bool negate);
+    template <typename E>
+    void accumulate(Integer &acc, const Negate<E> &n, bool negate);
+
+    // -----------------------------------------------------
+    // bound(e)
+    // Limbs enough to hold the value of e.
+    // -----------------------------------------------------
+    inline std::size_t bound(const Ref &r)
+    {
+        return r.value.limbCount();
+    }
+
+    template <typename L, typename R>
+    std::size_t bound(const Product<L, R> &p)
+    {
+        return bound(p.left) + bound(p.right);
+    }
+
+    template <typename L, typename R, bool S>
+    std::size_t bound(const Sum<L, R, S> &s)
+    {
+        return std::max(bound(s.left), bound(s.right)) + 1;
+    }
+
+    template <typename E>
+    std::size_t bound(const Negate<E> &n)
+    {
+        return bound(n.operand);
+    }
+
+    // -----------------------------------------------------
+    // refersTo(e,x)
+    // True if x is an operand of e.
+    // -----------------------------------------------------
+    inline bool refersTo(const Ref &r, const Integer *x)
+    {
+        return &r.value == x;
+    }
+
+    template <typename L, typename R>
+    bool refersTo(const Product<L, R> &p, const Integer *x)
+    {
+        return refersTo(p.left, x) || refersTo(p.right, x);
+    }
+
+    template <typename L, typename R, bool S>
+    bool refersTo(const Sum<L, R, S> &s, const Integer *x)
+    {
+        return refersTo(s.left, x) || refersTo(s.right, x);
+    }
+
+    template <typename E>
+    bool refersTo(const Negate<E> &n, const Integer *x)
+    {
+        return refersTo(n.operand, x);
+    }
+
+    // Value of a product factor: the operand itself, or the
+    // subexpression evaluated into tmp.
+    inline const Integer &factor(const Ref &r, Integer &)
+    {
+        return r.value;
+    }
+
+    template <typename E>
+    const Integer &factor(const E &e, Integer &tmp)
+    {
+        tmp = eval(e);
+        return tmp;
+    }
+
+    // -----------------------------------------------------
+    // accumulate(acc,e,negate)
+    // acc += e, or acc -= e when negate is set.
+    // -----------------------------------------------------
+    inline void accumulate(Integer &acc, const Ref &r, bool negate)
+    {
+        if (negate)
+            acc -= r.value;
+        else
+            acc += r.value;
+    }
+
+    // The fused case: a product of two operands.
+    inline void accumulate(Integer &acc, const Product<Ref, Ref> &p,
+                           bool negate)
+    {
+        if (negate)
+            acc.subMul(p.left.value, p.right.value);
+        else
+            acc.addMul(p.left.value, p.right.value);
+    }
+
+    template <typename L, typename R>
+    void accumulate(Integer &acc, const Product<L, R> &p, bool negate)
+    {
+        Integer l, r;
+        const Integer &x = factor(p.left, l);
+        const Integer &y = factor(p.right, r);
+        if (negate)
+            acc.subMul(x, y);
+        else
+            acc.addMul(x, y);
+    }
+
+    template <typename L, typename R, bool S>
+    void accumulate(Integer &acc, const Sum<L, R, S> &s, bool negate)
+    {
+        accumulate(acc, s.left, negate);
+        accumulate(acc, s.right, negate != S);
+    }
+
+    template <typename E>
+    void accumulate(Integer &acc, const Negate<E> &n, bool negate)
+    {
+        accumulate(acc, n.operand, !negate);
+    }
+}
+
+// ---------------------------------------------------------
+// assign(dest,e)
+// dest = e. Reuses dest's buffer unless dest is an operand
+// of e, in which case the value is formed aside and moved in.
+// ---------------------------------------------------------
+template <typename E>
+void assign(Integer &dest, const E &e)
+{
+    static_assert(IsExpr<E>::value, "expr::assign needs an expression");
+    if (detail::refersTo(e, &dest))
+    {
+        dest = eval(e);
+        return;
+    }
+    // Moving a zero in keeps dest's block.
+    dest = Integer();
+    dest.reserve(detail::bound(e));
+    detail::accumulate(dest, e, false);
+}
+
+// ---------------------------------------------------------
+// eval(e)
+// Returns the value of e.
+// ---------------------------------------------------------
+template <typename E>
+Integer eval(const E &e)
+{
+    static_assert(IsExpr<E>::value, "expr::eval needs an expression");
+    Integer result;
+    result.reserve(detail::bound(e));
+    detail::accumulate(result, e, false);
+    return result;
+}
+
+} // namespace expr
+
+#endif // INTEGER_EXPR_H
@@ -0,0 +1,82 @@
+// ---------------------------------------------------------
+// File: IntegerView.cpp
+// Comparison and arithmetic on IntegerViews.
+//
+// Author: agent <agent@local>
+// Last Modification: 2026-10-16
+// ---------------------------------------------------------
+
+#include "IntegerView.h"
+#include "Limb.h"
+#include <algorithm>  // for std::max
+
+IntegerView::IntegerView(const Integer &x)
+  : ptr(x.limbs.data()), count(x.limbs.size()), negative(x.isNegative())
+{
+}
+
+IntegerView::IntegerView(bool neg, const Limb *limbs, std::size_t n)
+  : ptr(limbs), count(n), negative(neg && n != 0)
+{
+}
+
+IntegerView::IntegerView(bool neg, Limb w)
+  : word(w), count(w != 0), negative(neg && w != 0)
+{
+}
+
+Integer IntegerView::toInteger() const
+{
+  Integer x;
+  x.limbs.assign(limbs(), limbs() + count);
+  x.sign = negative;
+  return x;
+}
+
+int IntegerView::compare(const IntegerView &other) const
+{
+  if (negative != other.negative)
+    return negative ? -1 : 1;
+  int c;
+  if (count != other.count)
+    c = count < other.count ? -1 : 1;
+  else
+    c = limb::cmp(limbs(), other.limbs(), count);
+  return negative ? -c : c;
+}
+
+// ---------------------------------------------------------
+// add(a,b,subtract)
+// The result starts as a copy of a, the one copy any new
+// value needs, and b's limbs are added into it in place.
+// ---------------------------------------------------------
+Integer IntegerView::add(const IntegerView &a, const IntegerView &b,
+                         bool subtract)
+{
+  Integer r = a.toInteger();
+  if (!b.isZero())
+  {
+    r.reserve(std::max(a.count, b.count) + 1);
+    r.addLimbsInPlace(b.limbs(), b.count, b.negative != subtract);
+  }
+  return r;
+}
+
+Integer IntegerView::multiply(const IntegerView &a, const IntegerView &b)
+{
+  if (a.isZero() || b.isZero())
+    return Integer();
+  const IntegerView &big = a.count >= b.count ? a : b;
+  const IntegerView &small = a.count >= b.count ? b : a;
+
+  Integer r;
+  r.limbs.resize(big.count + small.count);
+  if (big.limbs() == small.limbs() && big.count == small.count)
+    limb::sqr(r.limbs.data(), big.limbs(), big.count);
+  else
+    limb::mul(r.limbs.data(), big.limbs(), big.count,
+              small.limbs(), small.count);
+  r.sign = a.negative != b.negative;
+  r.normalize();
+  return r;
+}
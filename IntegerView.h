@@ -0,0 +1,98 @@
+// ---------------------------------------------------------
+// File: IntegerView.h
+// Read-only, non-owning view of an integer's limbs.
+//
+// Author: agent <agent@local>
+// Last Modification: 2026-10-16
+//
+// An IntegerView is a sign plus a pointer to a normalized
+// magnitude that lives elsewhere: in an Integer, or in a
+// serialized buffer or memory-mapped file (see Serialize.h).
+// Comparisons read the limbs in place, and +, - and * take
+// views as operands, so stored values feed arithmetic without
+// first being copied into Integers. Values of one limb may be
+// held in the view itself, as serial::Reader does for values
+// encoded inline.
+//
+// A view does not keep its limbs alive: the Integer or buffer
+// must outlive it and stay unchanged.
+// ---------------------------------------------------------
+
+#ifndef INTEGER_VIEW_H
+#define INTEGER_VIEW_H
+
+#include "Integer.h"
+#include <cstddef>
+
+class IntegerView
+{
+public:
+    using Limb = Integer::Limb;
+
+    // -------------------------------------------------------
+    // Constructors
+    // The default view is zero. A view of an Integer converts
+    // implicitly, so Integers mix with views in comparisons and
+    // arithmetic.
+    // Preconditions for (negative,limbs,n): n == 0 or
+    // limbs[n-1] != 0; limbs aligned for Limb.
+    // -------------------------------------------------------
+    IntegerView() = default;
+    IntegerView(const Integer &x);
+    IntegerView(bool negative, const Limb *limbs, std::size_t n);
+
+    // A value of at most one limb, stored in the view.
+    IntegerView(bool negative, Limb word);
+
+    bool isZero() const { return count == 0; }
+    bool isNegative() const { return negative; }
+    std::size_t limbCount() const { return count; }
+
+    // The magnitude, least significant limb first.
+    const Limb *limbs() const { return ptr ? ptr : &word; }
+
+    // Copies the value into an Integer.
+    Integer toInteger() const;
+
+    // -1, 0 or 1 as *this is less than, equal to or greater
+    // than other.
+    int compare(const IntegerView &other) const;
+
+    friend bool operator==(const IntegerView &a, const IntegerView &b)
+    { return a.compare(b) == 0; }
+    friend bool operator!=(const IntegerView &a, const IntegerView &b)
+    { return a.compare(b) != 0; }
+    friend bool operator<(const IntegerView &a, const IntegerView &b)
+    { return a.compare(b) < 0; }
+    friend bool operator<=(const IntegerView &a, const IntegerView &b)
+    { return a.compare(b) <= 0; }
+    friend bool operator>(const IntegerView &a, const IntegerView &b)
+    { return a.compare(b) > 0; }
+    friend bool operator>=(const IntegerView &a, const IntegerView &b)
+    { return a.compare(b) >= 0; }
+
+    // -------------------------------------------------------
+    // Arithmetic operators +, -, *
+    // Results are new Integers; the operands are read in
+    // place. Products use the same algorithms as Integer's
+    // operator*.
+    // -------------------------------------------------------
+    friend Integer operator+(const IntegerView &a, const IntegerView &b)
+    { return add(a, b, false); }
+    friend Integer operator-(const IntegerView &a, const IntegerView &b)
+    { return add(a, b, true); }
+    friend Integer operator*(const IntegerView &a, const IntegerView &b)
+    { return multiply(a, b); }
+
+private:
+    static Integer add(const IntegerView &a, const IntegerView &b,
+                       bool subtract);
+    static Integer multiply(const IntegerView &a, const IntegerView &b);
+
+    const Limb *ptr = nullptr;  // nullptr: the magnitude is word
+    Limb word = 0;
+    std::size_t count = 0;
+    bool negative = false;
+};
+
+#endif // INTEGER_VIEW_H
@@ -0,0 +1,168 @@
+// ---------------------------------------------------------
+// File: Limb.cpp
+// Basic carry-propagating kernels on 64-bit limb arrays.
+//
+// Author: agent <agent@local>
+// Last Modification: 2026-10-16
+//
+// Addition and subtraction detect carries with unsigned
+// compares; products use 128-bit intermediates. cmp, add_n and
+// sub_n have vector variants and live in LimbSimd.cpp.
+// ---------------------------------------------------------
+
+#include "Limb.h"
+
+namespace limb
+{
+
+std::size_t normalizedSize(const Limb *a, std::size_t n)
+{
+  while (n > 0 && a[n-1] == 0)
+    --n;
+  return n;
+}
+
+Limb add(Limb *r, const Limb *a, std::size_t an,
+         const Limb *b, std::size_t bn)
+{
+  Limb carry = add_n(r, a, b, bn);
+  for (std::size_t i = bn; i < an; ++i)
+  {
+    r[i] = a[i] + carry;
+    carry = r[i] < carry;
+  }
+  return carry;
+}
+
+Limb sub(Limb *r, const Limb *a, std::size_t an,
+         const Limb *b, std::size_t bn)
+{
+  Limb borrow = sub_n(r, a, b, bn);
+  for (std::size_t i = bn; i < an; ++i)
+  {
+    Limb ai = a[i];
+    r[i] = ai - borrow;
+    borrow = ai < borrow;
+  }
+  return borrow;
+}
+
+Limb add_1(Limb *r, const Limb *a, std::size_t n, Limb b)
+{
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    Limb ai = a[i];
+    r[i] = ai + b;
+    b = r[i] < ai;
+  }
+  return b;
+}
+
+Limb sub_1(Limb *r, const Limb *a, std::size_t n, Limb b)
+{
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    Limb ai = a[i];
+    r[i] = ai - b;
+    b = ai < b;
+  }
+  return b;
+}
+
+Limb lshift(Limb *r, const Limb *a, std::size_t n, unsigned s)
+{
+  Limb out = a[n-1] >> (64 - s);
+  for (std::size_t i = n - 1; i > 0; --i)
+    r[i] = (a[i] << s) | (a[i-1] >> (64 - s));
+  r[0] = a[0] << s;
+  return out;
+}
+
+Limb rshift(Limb *r, const Limb *a, std::size_t n, unsigned s)
+{
+  Limb out = a[0] << (64 - s);
+  for (std::size_t i = 0; i + 1 < n; ++i)
+    r[i] = (a[i] >> s) | (a[i+1] << (64 - s));
+  r[n-1] = a[n-1] >> s;
+  return out;
+}
+
+Limb mul_1(Limb *r, const Limb *a, std::size_t n, Limb b)
+{
+  Limb carry = 0;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    DoubleLimb t = static_cast<DoubleLimb>(a[i]) * b + carry;
+    r[i] = static_cast<Limb>(t);
+    carry = static_cast<Limb>(t >> 64);
+  }
+  return carry;
+}
+
+Limb addmul_1(Limb *r, const Limb *a, std::size_t n, Limb b)
+{
+  Limb carry = 0;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    DoubleLimb t = static_cast<DoubleLimb>(a[i]) * b + r[i] + carry;
+    r[i] = static_cast<Limb>(t);
+    carry = static_cast<Limb>(t >> 64);
+  }
+  return carry;
+}
+
+Limb submul_1(Limb *r, const Limb *a, std::size_t n, Limb b)
+{
+  Limb borrow = 0;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    DoubleLimb t = static_cast<DoubleLimb>(a[i]) * b + borrow;
+    Limb lo = static_cast<Limb>(t);
+    Limb ri = r[i];
+    r[i] = ri - lo;
+    borrow = static_cast<Limb>(t >> 64) + (ri < lo);
+  }
+  return borrow;
+}
+
+void mul_basecase(Limb *r, const Limb *a, std::size_t an,
+                  const Limb *b, std::size_t bn)
+{
+  r[an] = mul_1(r, a, an, b[0]);
+  for (std::size_t j = 1; j < bn; ++j)
+    r[an + j] = addmul_1(r + j, a, an, b[j]);
+}
+
+void sqr_basecase(Limb *r, const Limb *a, std::size_t n)
+{
+  DoubleLimb p = static_cast<DoubleLimb>(a[0]) * a[0];
+  if (n == 1)
+  {
+    r[0] = static_cast<Limb>(p);
+    r[1] = static_cast<Limb>(p >> 64);
+    return;
+  }
+
+  // Row i adds a[i]*a[i+1..n) at r + 2i + 1; its carry lands
+  // on r[n+i], one past everything written so far.
+  r[0] = 0;
+  r[n] = mul_1(r + 1, a + 1, n - 1, a[0]);
+  for (std::size_t i = 1; i + 1 < n; ++i)
+    r[n + i] = addmul_1(r + 2*i + 1, a + i + 1, n - i - 1, a[i]);
+  r[2*n - 1] = lshift(r + 1, r + 1, 2*n - 2, 1);
+
+  Limb carry = 0;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    p = static_cast<DoubleLimb>(a[i]) * a[i];
+    DoubleLimb t = static_cast<DoubleLimb>(r[2*i]) + static_cast<Limb>(p)
+                   + carry;
+    r[2*i] = static_cast<Limb>(t);
+    t = static_cast<DoubleLimb>(r[2*i + 1]) + static_cast<Limb>(p >> 64)
+        + static_cast<Limb>(t >> 64);
+    r[2*i + 1] = static_cast<Limb>(t);
+    carry = static_cast<Limb>(t >> 64);
+  }
+}
+
+} // namespace limb
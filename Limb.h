@@ -0,0 +1,249 @@
+// ---------------------------------------------------------
+// File: Limb.h
+// Low-level kernels on little-endian arrays of 64-bit limbs.
+//
+// Author: agent <agent@local>
+// Last Modification: 2026-10-16
+//
+// Internal to the Integer implementation. Every routine works
+// on raw (pointer, length) spans, never allocates its output,
+// and leaves sign handling and normalization to the caller.
+// Unless stated otherwise the result span must not overlap
+// the inputs.
+// ---------------------------------------------------------
+
+#ifndef LIMB_H
+#define LIMB_H
+
+#include "Integer.h"
+#include "LimbVector.h"
+#include <cstddef>
+
+namespace limb
+{
+
+using Limb = Integer::Limb;
+using DoubleLimb = unsigned __int128;
+
+// ---------------------------------------------------------
+// normalizedSize(a,n)
+// Returns n with high zero limbs dropped.
+// ---------------------------------------------------------
+std::size_t normalizedSize(const Limb *a, std::size_t n);
+
+// ---------------------------------------------------------
+// Simd, simd(), setSimd(level)
+// Instruction set used by cmp, add_n, sub_n and the word lane
+// kernels below. It is the best one the CPU supports unless
+// setSimd() lowers it, e.g. to compare variants; setSimd()
+// returns the level it applied.
+// ---------------------------------------------------------
+enum class Simd { Scalar, Avx2, Avx512 };
+Simd simd();
+Simd setSimd(Simd level);
+
+// ---------------------------------------------------------
+// cmp(a,b,n)
+// Compare two n-limb magnitudes: -1, 0 or 1.
+// ---------------------------------------------------------
+int cmp(const Limb *a, const Limb *b, std::size_t n);
+
+// ---------------------------------------------------------
+// add_n / sub_n(r,a,b,n)
+// r = a +/- b over n limbs. Returns the carry/borrow out.
+// r may alias a or b.
+// ---------------------------------------------------------
+Limb add_n(Limb *r, const Limb *a, const Limb *b, std::size_t n);
+Limb sub_n(Limb *r, const Limb *a, const Limb *b, std::size_t n);
+
+// ---------------------------------------------------------
+// add_words / sub_words / mul_words(r,a,b,n)
+// Element-wise r[i] = a[i] +/- * b[i] over n signed words, for
+// IntegerBatch. wordMark stands for a value kept elsewhere: a
+// lane gets wordMark if either operand is wordMark or the
+// result overflows or is wordMark itself. mul_words may also
+// mark lanes whose operands do not both fit in 32 bits even
+// though the product fits; the caller retries marked lanes.
+// Returns the number of marked lanes. r may alias a or b.
+// ---------------------------------------------------------
+const long long wordMark = -0x7FFFFFFFFFFFFFFFLL - 1;
+
+std::size_t add_words(long long *r, const long long *a, const long long *b,
+                      std::size_t n);
+std::size_t sub_words(long long *r, const long long *a, const long long *b,
+                      std::size_t n);
+std::size_t mul_words(long long *r, const long long *a, const long long *b,
+                      std::size_t n);
+
+// ---------------------------------------------------------
+// cmp_words(r,a,b,n)
+// r[i] = -1, 0 or 1 as a[i] is less than, equal to or greater
+// than b[i]. Returns the number of lanes where either operand
+// is wordMark; their r[i] is meaningless.
+// ---------------------------------------------------------
+std::size_t cmp_words(signed char *r, const long long *a, const long long *b,
+                      std::size_t n);
+
+// ---------------------------------------------------------
+// add / sub(r,a,an,b,bn)
+// r[0..an) = a +/- b. Preconditions: an >= bn.
+// Returns the carry/borrow out. r may alias a or b.
+// ---------------------------------------------------------
+Limb add(Limb *r, const Limb *a, std::size_t an,
+         const Limb *b, std::size_t bn);
+Limb sub(Limb *r, const Limb *a, std::size_t an,
+         const Limb *b, std::size_t bn);
+
+// ---------------------------------------------------------
+// add_1 / sub_1(r,a,n,b)
+// r[0..n) = a +/- b for a single limb b. Returns the carry/
+// borrow out. r may alias a.
+// ---------------------------------------------------------
+Limb add_1(Limb *r, const Limb *a, std::size_t n, Limb b);
+Limb sub_1(Limb *r, const Limb *a, std::size_t n, Limb b);
+
+// ---------------------------------------------------------
+// lshift / rshift(r,a,n,s)
+// r[0..n) = a << s or a >> s for 0 < s < 64. Returns the bits
+// shifted out (in the low bits for lshift, the high bits for
+// rshift). r may alias a.
+// ---------------------------------------------------------
+Limb lshift(Limb *r, const Limb *a, std::size_t n, unsigned s);
+Limb rshift(Limb *r, const Limb *a, std::size_t n, unsigned s);
+
+// ---------------------------------------------------------
+// mul_1 / addmul_1 / submul_1(r,a,n,b)
+// r = a*b, r += a*b or r -= a*b over n limbs. Returns the
+// high limb (the borrow for submul_1). mul_1 allows r == a.
+// ---------------------------------------------------------
+Limb mul_1(Limb *r, const Limb *a, std::size_t n, Limb b);
+Limb addmul_1(Limb *r, const Limb *a, std::size_t n, Limb b);
+Limb submul_1(Limb *r, const Limb *a, std::size_t n, Limb b);
+
+// ---------------------------------------------------------
+// mul_basecase(r,a,an,b,bn)
+// Schoolbook r[0..an+bn) = a*b.
+// ---------------------------------------------------------
+void mul_basecase(Limb *r, const Limb *a, std::size_t an,
+                  const Limb *b, std::size_t bn);
+
+// ---------------------------------------------------------
+// sqr_basecase(r,a,n)
+// Schoolbook r[0..2n) = a^2: each cross product a[i]*a[j],
+// i < j, is formed once, the sum is doubled and the squares
+// a[i]^2 are added in. Preconditions: n >= 1.
+// ---------------------------------------------------------
+void sqr_basecase(Limb *r, const Limb *a, std::size_t n);
+
+// ---------------------------------------------------------
+// mul_ntt(r,a,an,b,bn)
+// r[0..an+bn) = a*b via a three-prime number-theoretic
+// transform. Passing the same array for a and b (a square)
+// transforms it once per prime instead of twice.
+// Preconditions: an, bn >= 1, an + bn <= 2^42.
+// ---------------------------------------------------------
+void mul_ntt(Limb *r, const Limb *a, std::size_t an,
+             const Limb *b, std::size_t bn);
+
+// ---------------------------------------------------------
+// mul(r,a,an,b,bn)
+// r[0..an+bn) = a*b, picking schoolbook, Karatsuba, Toom-3,
+// NTT or the unbalanced strategy from
+// Integer::multiplyThresholds().
+// Preconditions: an >= bn >= 1.
+// ---------------------------------------------------------
+void mul(Limb *r, const Limb *a, std::size_t an,
+         const Limb *b, std::size_t bn);
+
+// ---------------------------------------------------------
+// sqr(r,a,n)
+// r[0..2n) = a^2 with the squaring variants of the mul()
+// algorithms, switching at the square* sizes of
+// Integer::multiplyThresholds(). Preconditions: n >= 1.
+// ---------------------------------------------------------
+void sqr(Limb *r, const Limb *a, std::size_t n);
+
+// ---------------------------------------------------------
+// divrem_1(q,a,n,d)
+// q[0..n) = a / d using a precomputed reciprocal of d.
+// Preconditions: d != 0. Returns a % d. q may alias a.
+// ---------------------------------------------------------
+Limb divrem_1(Limb *q, const Limb *a, std::size_t n, Limb d);
+
+// ---------------------------------------------------------
+// divrem(q,r,a,an,d,dn)
+// q[0..an-dn+1) = a / d and r[0..dn) = a % d. Uses divrem_1
+// for one-limb divisors, Knuth's Algorithm D below
+// Integer::divideThresholds().divideAndConquer limbs,
+// recursive divide-and-conquer division above it and Newton/
+// Barrett division once divisor and quotient both reach
+// Integer::divideThresholds().newton limbs.
+// Preconditions: an >= dn >= 1, d[dn-1] != 0.
+// ---------------------------------------------------------
+void divrem(Limb *q, Limb *r, const Limb *a, std::size_t an,
+            const Limb *d, std::size_t dn);
+
+// ---------------------------------------------------------
+// Divisor
+// A divisor prepared for repeated division: normalized once
+// and, from Integer::divideThresholds().newton limbs on or
+// when asked for, with its Newton reciprocal, so each
+// division costs about two multiplications.
+// ---------------------------------------------------------
+class Divisor
+{
+public:
+  // reciprocal forces the Newton reciprocal below the
+  // threshold, for divisors reused often enough to repay it.
+  // Preconditions: dn >= 1, d[dn-1] != 0.
+  Divisor(const Limb *d, std::size_t dn, bool reciprocal = false);
+
+  std::size_t size() const { return norm.size(); }
+
+  // q[0..an-size()+1) = a / d and r[0..size()) = a % d.
+  // Preconditions: an >= size().
+  void divrem(Limb *q, Limb *r, const Limb *a, std::size_t an) const;
+
+private:
+  LimbVector norm;     // d << shift, top bit set
+  unsigned shift;
+  LimbVector inverse;  // empty without a reciprocal
+};
+
+// ---------------------------------------------------------
+// get_str(s,a,n,base)
+// Writes the digits of a in the given base (values 0..base-1,
+// most significant first, no leading zeros) to s and returns
+// their count; s needs get_str_size(n,base) entries. Linear
+// for power-of-two bases, divide-and-conquer otherwise.
+// Preconditions: n >= 1, a[n-1] != 0, 2 <= base <= 256.
+// ---------------------------------------------------------
+std::size_t get_str_size(std::size_t n, unsigned base);
+std::size_t get_str(unsigned char *s, const Limb *a, std::size_t n,
+                    unsigned base);
+
+// ---------------------------------------------------------
+// set_str(r,s,len,base)
+// Inverse of get_str: r = the value of the len digit values in
+// s, most significant first. Returns the normalized size; r
+// needs set_str_size(len,base) limbs.
+// Preconditions: every s[i] < base, 2 <= base <= 256.
+// ---------------------------------------------------------
+std::size_t set_str_size(std::size_t len, unsigned base);
+std::size_t set_str(Limb *r, const unsigned char *s, std::size_t len,
+                    unsigned base);
+
+// ---------------------------------------------------------
+// gcd(g,a,an,b,bn)
+// Writes gcd(a,b) to g and returns its size. Binary GCD for
+// single limbs, Lehmer below Integer::gcdThresholds().halfGcd
+// limbs and subquadratic half-GCD above it.
+// Preconditions: an, bn >= 1, both normalized; g has room for
+// min(an,bn) limbs.
+// ---------------------------------------------------------
+std::size_t gcd(Limb *g, const Limb *a, std::size_t an,
+                const Limb *b, std::size_t bn);
+
+} // namespace limb
+
+#endif // LIMB_H
@@ -0,0 +1,193 @@
+// ---------------------------------------------------------
+// File: LimbAllocator.cpp
+// Heap, pool and arena allocators for limb buffers.
+//
+// Author: agent <agent@local>
+// Last Modification: 2026-10-16
+// ---------------------------------------------------------
+
+#include "LimbAllocator.h"
+#include "Stats.h"
+#include <algorithm>  // for std::max
+
+namespace
+{
+
+LimbAllocator::Limb *heapAllocate(std::size_t n)
+{
+  LimbAllocator::Limb *p = new LimbAllocator::Limb[n];
+  INTEGER_STATS_ALLOC(n);
+  return p;
+}
+
+class HeapAllocator : public LimbAllocator
+{
+public:
+  Limb *allocate(std::size_t &n) override
+  {
+    return heapAllocate(n);
+  }
+
+  void deallocate(Limb *p, std::size_t) noexcept override
+  {
+    delete[] p;
+  }
+};
+
+// ---------------------------------------------------------
+// Pool
+// Class k holds free blocks of exactly 2^k limbs, linked
+// through their first limb. The lists are plain thread-local
+// data; a separate guard drains them at thread exit and marks
+// them closed, so blocks freed later during shutdown go
+// straight back to the heap.
+// ---------------------------------------------------------
+const unsigned minClass = 2;
+const unsigned maxClass = 16;
+const std::size_t cachedLimbs = std::size_t(1) << 16;
+
+struct FreeLists
+{
+  LimbAllocator::Limb *head[maxClass + 1];
+  std::size_t count[maxClass + 1];
+  bool closed;
+};
+
+thread_local FreeLists freeLists = {};
+
+LimbAllocator::Limb *&link(LimbAllocator::Limb *p)
+{
+  return *reinterpret_cast<LimbAllocator::Limb **>(p);
+}
+
+struct FreeListGuard
+{
+  ~FreeListGuard()
+  {
+    for (unsigned k = minClass; k <= maxClass; ++k)
+      while (LimbAllocator::Limb *p = freeLists.head[k])
+      {
+        freeLists.head[k] = link(p);
+        delete[] p;
+      }
+    freeLists.closed = true;
+  }
+};
+
+thread_local FreeListGuard freeListGuard;
+
+unsigned sizeClass(std::size_t n)
+{
+  unsigned k = n <= 1 ? 0 : 64 - __builtin_clzll(n - 1);
+  return std::max(k, minClass);
+}
+
+class PoolAllocator : public LimbAllocator
+{
+public:
+  Limb *allocate(std::size_t &n) override
+  {
+    unsigned k = sizeClass(n);
+    if (k > maxClass)
+      return heapAllocate(n);
+    n = std::size_t(1) << k;
+    FreeLists &lists = freeLists;
+    if (Limb *p = lists.head[k])
+    {
+      lists.head[k] = link(p);
+      --lists.count[k];
+      return p;
+    }
+    return heapAllocate(n);
+  }
+
+  void deallocate(Limb *p, std::size_t n) noexcept override
+  {
+    unsigned k = sizeClass(n);
+    FreeLists &lists = freeLists;
+    if (k > maxClass || lists.closed
+        || (lists.count[k] + 1) << k > cachedLimbs)
+    {
+      delete[] p;
+      return;
+    }
+    // Registers the guard's destructor for this thread.
+    (void)&freeListGuard;
+    link(p) = lists.head[k];
+    lists.head[k] = p;
+    ++lists.count[k];
+  }
+};
+
+thread_local LimbAllocator *currentAllocator = nullptr;
+
+} // namespace
+
+// ---------------------------------------------------------
+// LimbAllocator
+// ---------------------------------------------------------
+LimbAllocator &LimbAllocator::heap()
+{
+  static HeapAllocator allocator;
+  return allocator;
+}
+
+LimbAllocator &LimbAllocator::pool()
+{
+  static PoolAllocator allocator;
+  return allocator;
+}
+
+LimbAllocator &LimbAllocator::current()
+{
+  return currentAllocator ? *currentAllocator : pool();
+}
+
+// ---------------------------------------------------------
+// LimbArena
+// ---------------------------------------------------------
+LimbArena::LimbArena(std::size_t chunk)
+  : chunkLimbs(std::max<std::size_t>(chunk, 64))
+{
+}
+
+LimbArena::~LimbArena()
+{
+  for (Limb *c : chunks)
+    delete[] c;
+}
+
+LimbArena::Limb *LimbArena::allocate(std::size_t &n)
+{
+  if (static_cast<std::size_t>(last - next) < n)
+  {
+    // The rest of the current chunk is abandoned.
+    std::size_t size = std::max(n, chunkLimbs);
+    chunks.reserve(chunks.size() + 1);
+    next = heapAllocate(size);
+    last = next + size;
+    chunks.push_back(next);
+  }
+  Limb *p = next;
+  next += n;
+  handedOut += n;
+  return p;
+}
+
+void LimbArena::deallocate(Limb *, std::size_t) noexcept
+{
+}
+
+// ---------------------------------------------------------
+// LimbAllocatorScope
+// ---------------------------------------------------------
+LimbAllocatorScope::LimbAllocatorScope(LimbAllocator &allocator)
+  : previous(currentAllocator)
+{
+  currentAllocator = &allocator;
+}
+
+LimbAllocatorScope::~LimbAllocatorScope()
+{
+  currentAllocator = previous;
+}
@@ -0,0 +1,125 @@
+// ---------------------------------------------------------
+// File: LimbAllocator.h
+// Pluggable storage for the limb buffers of Integer.
+//
+// Author: agent <agent@local>
+// Last Modification: 2026-10-16
+//
+// Every LimbVector that spills out of its inline buffer takes
+// a block from the calling thread's current allocator and
+// remembers which allocator that was, so the block goes back
+// to the right place wherever it is freed. By default the
+// current allocator is pool(): per-thread free lists of
+// power-of-two blocks, so the temporaries of an expression
+// reuse the memory of the previous ones instead of going
+// through malloc. A LimbAllocatorScope selects another one,
+// such as heap() or a LimbArena, for a stretch of code.
+// ---------------------------------------------------------
+
+#ifndef LIMB_ALLOCATOR_H
+#define LIMB_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ---------------------------------------------------------
+// Class: LimbAllocator
+// Interface of a limb block source. Implementations must
+// accept deallocate() from any thread; allocate() is only
+// called by threads that made the allocator current.
+// ---------------------------------------------------------
+class LimbAllocator
+{
+public:
+  using Limb = std::uint64_t;
+
+  virtual ~LimbAllocator() = default;
+
+  // -------------------------------------------------------
+  // allocate(n)
+  // Returns a block of at least n limbs and sets n to its
+  // actual size. Throws std::bad_alloc when out of memory.
+  // -------------------------------------------------------
+  virtual Limb *allocate(std::size_t &n) = 0;
+
+  // -------------------------------------------------------
+  // deallocate(p,n)
+  // Returns a block from allocate(); n is the size it set.
+  // -------------------------------------------------------
+  virtual void deallocate(Limb *p, std::size_t n) noexcept = 0;
+
+  // Plain new[] and delete[].
+  static LimbAllocator &heap();
+
+  // Thread-local size classes of 2^k limbs up to 2^16; a
+  // thread keeps at most 2^16 free limbs per class and hands
+  // larger blocks straight to the heap.
+  static LimbAllocator &pool();
+
+  // The calling thread's allocator: the innermost
+  // LimbAllocatorScope, else pool().
+  static LimbAllocator &current();
+};
+
+// ---------------------------------------------------------
+// Class: LimbArena
+// Monotonic allocator: blocks are carved from large chunks
+// and deallocate() is a no-op; everything is released at
+// once when the arena is destroyed. Every value allocated
+// from it must be destroyed first. To keep a result, copy it
+// while another allocator is current:
+//
+//   Integer result;
+//   {
+//     LimbArena arena;
+//     LimbAllocatorScope inArena(arena);
+//     Integer x = ...;               // temporaries in arena
+//     LimbAllocatorScope out(LimbAllocator::pool());
+//     result = x;                    // copied to the pool
+//   }
+// ---------------------------------------------------------
+class LimbArena : public LimbAllocator
+{
+public:
+  // Chunks hold at least chunkLimbs limbs.
+  explicit LimbArena(std::size_t chunkLimbs = std::size_t(1) << 15);
+  ~LimbArena() override;
+
+  LimbArena(const LimbArena &) = delete;
+  LimbArena &operator=(const LimbArena &) = delete;
+
+  Limb *allocate(std::size_t &n) override;
+  void deallocate(Limb *p, std::size_t n) noexcept override;
+
+  // Limbs handed out since construction.
+  std::size_t used() const { return handedOut; }
+
+private:
+  std::size_t chunkLimbs;
+  std::vector<Limb *> chunks;
+  Limb *next = nullptr;
+  Limb *last = nullptr;
+  std::size_t handedOut = 0;
+};
+
+// ---------------------------------------------------------
+// Class: LimbAllocatorScope
+// Makes an allocator current for the calling thread while it
+// lives; scopes nest. Threads of the multiplication pool keep
+// their own current allocator.
+// ---------------------------------------------------------
+class LimbAllocatorScope
+{
+public:
+  explicit LimbAllocatorScope(LimbAllocator &allocator);
+  ~LimbAllocatorScope();
+
+  LimbAllocatorScope(const LimbAllocatorScope &) = delete;
+  LimbAllocatorScope &operator=(const LimbAllocatorScope &) = delete;
+
+private:
+  LimbAllocator *previous;
+};
+
+#endif // LIMB_ALLOCATOR_H
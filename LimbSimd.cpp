@@ -0,0 +1,602 @@
+// ---------------------------------------------------------
+// File: LimbSimd.cpp
+// cmp, add_n, sub_n and the word lane kernels with AVX2 and
+// AVX-512 variants picked at run time.
+//
+// Author: agent <agent@local>
+// Last Modification: 2026-10-16
+//
+// The vector adders form all lane sums at once and resolve
+// the carries between lanes with scalar bit arithmetic on the
+// lane masks: with G the lanes that overflowed, P the lanes
+// that are all ones and c the carry in, the lanes that receive
+// a carry are ((G << 1 | c) + P) ^ P, and the bit above the
+// top lane is the carry out. Subtraction is the same with
+// borrows, P then marking zero lanes. The comparison scans
+// from the top for the first block with a differing lane.
+//
+// The word lane kernels treat every lane as an independent
+// signed value and collect the lanes to mark as a bit mask.
+// Vector products use the 32 x 32 -> 64 bit multiply, exact
+// when both operands fit in 32 bits; other lanes are marked
+// for the caller to retry.
+//
+// The scalar versions serve other CPUs and the tails.
+// ---------------------------------------------------------
+
+#include "Limb.h"
+#include <atomic>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define LIMB_X86 1
+#endif
+
+namespace limb
+{
+
+namespace
+{
+
+// ---------------------------------------------------------
+// Scalar kernels
+// ---------------------------------------------------------
+int cmpScalar(const Limb *a, const Limb *b, std::size_t n)
+{
+  for (std::size_t i = n; i-- > 0;)
+  {
+    if (a[i] != b[i])
+      return a[i] < b[i] ? -1 : 1;
+  }
+  return 0;
+}
+
+Limb addScalar(Limb *r, const Limb *a, const Limb *b, std::size_t n,
+               Limb carry)
+{
+#ifdef LIMB_X86
+  // Compiles to an adc chain.
+  unsigned char c = static_cast<unsigned char>(carry);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    unsigned long long s;
+    c = _addcarry_u64(c, a[i], b[i], &s);
+    r[i] = s;
+  }
+  return c;
+#else
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    Limb s = a[i] + b[i];
+    Limb c1 = s < a[i];
+    r[i] = s + carry;
+    carry = c1 | (r[i] < s);
+  }
+  return carry;
+#endif
+}
+
+Limb subScalar(Limb *r, const Limb *a, const Limb *b, std::size_t n,
+               Limb borrow)
+{
+#ifdef LIMB_X86
+  unsigned char c = static_cast<unsigned char>(borrow);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    unsigned long long d;
+    c = _subborrow_u64(c, a[i], b[i], &d);
+    r[i] = d;
+  }
+  return c;
+#else
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    Limb ai = a[i], bi = b[i];
+    Limb diff = ai - bi;
+    Limb b1 = ai < bi;
+    r[i] = diff - borrow;
+    borrow = b1 | (diff < borrow);
+  }
+  return borrow;
+#endif
+}
+
+// Word lanes, with the overflow checks of the builtins.
+template <bool Subtract>
+std::size_t addWordsScalar(long long *r, const long long *a,
+                           const long long *b, std::size_t n)
+{
+  std::size_t marked = 0;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    long long x = a[i], y = b[i], z;
+    bool bad = Subtract ? __builtin_sub_overflow(x, y, &z)
+                        : __builtin_add_overflow(x, y, &z);
+    bad |= x == wordMark || y == wordMark || z == wordMark;
+    r[i] = bad ? wordMark : z;
+    marked += bad;
+  }
+  return marked;
+}
+
+std::size_t mulWordsScalar(long long *r, const long long *a,
+                           const long long *b, std::size_t n)
+{
+  std::size_t marked = 0;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    long long x = a[i], y = b[i], z;
+    bool bad = __builtin_mul_overflow(x, y, &z);
+    bad |= x == wordMark || y == wordMark || z == wordMark;
+    r[i] = bad ? wordMark : z;
+    marked += bad;
+  }
+  return marked;
+}
+
+std::size_t cmpWordsScalar(signed char *r, const long long *a,
+                           const long long *b, std::size_t n)
+{
+  std::size_t marked = 0;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    long long x = a[i], y = b[i];
+    r[i] = static_cast<signed char>((x > y) - (x < y));
+    marked += x == wordMark || y == wordMark;
+  }
+  return marked;
+}
+
+#ifdef LIMB_X86
+
+// ---------------------------------------------------------
+// AVX2: four limbs per step
+// ---------------------------------------------------------
+
+// Lanes whose bit is set in the 4-bit mask m become all ones,
+// the others zero.
+__attribute__((target("avx2")))
+inline __m256i expandMask(unsigned m)
+{
+  const __m256i bits = _mm256_setr_epi64x(1, 2, 4, 8);
+  __m256i v = _mm256_and_si256(_mm256_set1_epi64x(m), bits);
+  return _mm256_cmpeq_epi64(v, bits);
+}
+
+__attribute__((target("avx2")))
+inline unsigned laneMask(__m256i v)
+{
+  return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(v)));
+}
+
+__attribute__((target("avx2")))
+int cmpAvx2(const Limb *a, const Limb *b, std::size_t n)
+{
+  std::size_t i = n;
+  while (i >= 4)
+  {
+    i -= 4;
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+    unsigned diff = ~laneMask(_mm256_cmpeq_epi64(va, vb)) & 0xF;
+    if (diff)
+    {
+      std::size_t j = i + 31 - __builtin_clz(diff);
+      return a[j] < b[j] ? -1 : 1;
+    }
+  }
+  return cmpScalar(a, b, i);
+}
+
+__attribute__((target("avx2")))
+Limb addAvx2(Limb *r, const Limb *a, const Limb *b, std::size_t n)
+{
+  const __m256i ones = _mm256_set1_epi64x(-1);
+  const __m256i top = _mm256_set1_epi64x(static_cast<long long>(1ULL << 63));
+  unsigned carry = 0;
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+    __m256i s = _mm256_add_epi64(va, vb);
+    // Unsigned s < a as a signed compare with the top bits flipped.
+    unsigned g = laneMask(_mm256_cmpgt_epi64(_mm256_xor_si256(va, top),
+                                             _mm256_xor_si256(s, top)));
+    unsigned p = laneMask(_mm256_cmpeq_epi64(s, ones));
+    unsigned sum = ((g << 1) | carry) + p;
+    carry = sum >> 4;
+    // Subtracting an all-ones lane adds one.
+    s = _mm256_sub_epi64(s, expandMask((sum ^ p) & 0xF));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(r + i), s);
+  }
+  return addScalar(r + i, a + i, b + i, n - i, carry);
+}
+
+__attribute__((target("avx2")))
+Limb subAvx2(Limb *r, const Limb *a, const Limb *b, std::size_t n)
+{
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i top = _mm256_set1_epi64x(static_cast<long long>(1ULL << 63));
+  unsigned borrow = 0;
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+    __m256i d = _mm256_sub_epi64(va, vb);
+    unsigned g = laneMask(_mm256_cmpgt_epi64(_mm256_xor_si256(vb, top),
+                                             _mm256_xor_si256(va, top)));
+    unsigned p = laneMask(_mm256_cmpeq_epi64(d, zero));
+    unsigned sum = ((g << 1) | borrow) + p;
+    borrow = sum >> 4;
+    // Adding an all-ones lane subtracts one.
+    d = _mm256_add_epi64(d, expandMask((sum ^ p) & 0xF));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(r + i), d);
+  }
+  return subScalar(r + i, a + i, b + i, n - i, borrow);
+}
+
+// Lanes of a word that fit in 32 bits, as a 4-bit mask.
+__attribute__((target("avx2")))
+inline unsigned fits32(__m256i v)
+{
+  const __m256i bias = _mm256_set1_epi64x(0x80000000LL);
+  __m256i high = _mm256_srli_epi64(_mm256_add_epi64(v, bias), 32);
+  return laneMask(_mm256_cmpeq_epi64(high, _mm256_setzero_si256()));
+}
+
+// The sum s = a + b overflowed when its sign differs from
+// those of both a and b; the difference s = a - b when a and b
+// differ in sign and s differs from a.
+template <bool Subtract>
+__attribute__((target("avx2")))
+std::size_t addWordsAvx2(long long *r, const long long *a,
+                         const long long *b, std::size_t n)
+{
+  const __m256i mark = _mm256_set1_epi64x(wordMark);
+  std::size_t marked = 0, i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+    __m256i s = Subtract ? _mm256_sub_epi64(va, vb) : _mm256_add_epi64(va, vb);
+    __m256i flip = _mm256_xor_si256(va, s);
+    __m256i o = _mm256_and_si256(flip, Subtract ? _mm256_xor_si256(va, vb)
+                                                : _mm256_xor_si256(vb, s));
+    unsigned bad = laneMask(o)
+                   | laneMask(_mm256_cmpeq_epi64(va, mark))
+                   | laneMask(_mm256_cmpeq_epi64(vb, mark))
+                   | laneMask(_mm256_cmpeq_epi64(s, mark));
+    s = _mm256_blendv_epi8(s, mark, expandMask(bad));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(r + i), s);
+    marked += __builtin_popcount(bad);
+  }
+  return marked + addWordsScalar<Subtract>(r + i, a + i, b + i, n - i);
+}
+
+__attribute__((target("avx2")))
+std::size_t mulWordsAvx2(long long *r, const long long *a,
+                         const long long *b, std::size_t n)
+{
+  const __m256i mark = _mm256_set1_epi64x(wordMark);
+  std::size_t marked = 0, i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+    __m256i p = _mm256_mul_epi32(va, vb);
+    unsigned bad = ~(fits32(va) & fits32(vb)) & 0xF;
+    p = _mm256_blendv_epi8(p, mark, expandMask(bad));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(r + i), p);
+    marked += __builtin_popcount(bad);
+  }
+  return marked + mulWordsScalar(r + i, a + i, b + i, n - i);
+}
+
+__attribute__((target("avx2")))
+std::size_t cmpWordsAvx2(signed char *r, const long long *a,
+                         const long long *b, std::size_t n)
+{
+  const __m256i mark = _mm256_set1_epi64x(wordMark);
+  std::size_t marked = 0, i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+    unsigned gt = laneMask(_mm256_cmpgt_epi64(va, vb));
+    unsigned lt = laneMask(_mm256_cmpgt_epi64(vb, va));
+    for (unsigned k = 0; k < 4; ++k)
+      r[i + k] = static_cast<signed char>(((gt >> k) & 1) - ((lt >> k) & 1));
+    marked += __builtin_popcount(laneMask(_mm256_cmpeq_epi64(va, mark))
+                                 | laneMask(_mm256_cmpeq_epi64(vb, mark)));
+  }
+  return marked + cmpWordsScalar(r + i, a + i, b + i, n - i);
+}
+
+// ---------------------------------------------------------
+// AVX-512: eight limbs per step, masks in k registers
+// ---------------------------------------------------------
+__attribute__((target("avx512f")))
+int cmpAvx512(const Limb *a, const Limb *b, std::size_t n)
+{
+  std::size_t i = n;
+  while (i >= 8)
+  {
+    i -= 8;
+    __m512i va = _mm512_loadu_si512(a + i);
+    __m512i vb = _mm512_loadu_si512(b + i);
+    unsigned diff = _mm512_cmpneq_epu64_mask(va, vb);
+    if (diff)
+    {
+      std::size_t j = i + 31 - __builtin_clz(diff);
+      return a[j] < b[j] ? -1 : 1;
+    }
+  }
+  return cmpScalar(a, b, i);
+}
+
+__attribute__((target("avx512f")))
+Limb addAvx512(Limb *r, const Limb *a, const Limb *b, std::size_t n)
+{
+  const __m512i one = _mm512_set1_epi64(1);
+  const __m512i ones = _mm512_set1_epi64(-1);
+  unsigned carry = 0;
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    __m512i va = _mm512_loadu_si512(a + i);
+    __m512i vb = _mm512_loadu_si512(b + i);
+    __m512i s = _mm512_add_epi64(va, vb);
+    unsigned g = _mm512_cmplt_epu64_mask(s, va);
+    unsigned p = _mm512_cmpeq_epu64_mask(s, ones);
+    unsigned sum = ((g << 1) | carry) + p;
+    carry = sum >> 8;
+    s = _mm512_mask_add_epi64(s, static_cast<__mmask8>(sum ^ p), s, one);
+    _mm512_storeu_si512(r + i, s);
+  }
+  return addScalar(r + i, a + i, b + i, n - i, carry);
+}
+
+__attribute__((target("avx512f")))
+Limb subAvx512(Limb *r, const Limb *a, const Limb *b, std::size_t n)
+{
+  const __m512i one = _mm512_set1_epi64(1);
+  const __m512i zero = _mm512_setzero_si512();
+  unsigned borrow = 0;
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    __m512i va = _mm512_loadu_si512(a + i);
+    __m512i vb = _mm512_loadu_si512(b + i);
+    __m512i d = _mm512_sub_epi64(va, vb);
+    unsigned g = _mm512_cmplt_epu64_mask(va, vb);
+    unsigned p = _mm512_cmpeq_epu64_mask(d, zero);
+    unsigned sum = ((g << 1) | borrow) + p;
+    borrow = sum >> 8;
+    d = _mm512_mask_sub_epi64(d, static_cast<__mmask8>(sum ^ p), d, one);
+    _mm512_storeu_si512(r + i, d);
+  }
+  return subScalar(r + i, a + i, b + i, n - i, borrow);
+}
+
+// The zero-masked forms with every lane selected avoid the
+// undefined pass-through operand of the plain intrinsics, which
+// GCC reports as uninitialized.
+__attribute__((target("avx512f")))
+inline __mmask8 fits32(__m512i v)
+{
+  const __m512i bias = _mm512_set1_epi64(0x80000000LL);
+  __m512i high = _mm512_maskz_srli_epi64(0xFF, _mm512_add_epi64(v, bias), 32);
+  return _mm512_cmpeq_epi64_mask(high, _mm512_setzero_si512());
+}
+
+template <bool Subtract>
+__attribute__((target("avx512f")))
+std::size_t addWordsAvx512(long long *r, const long long *a,
+                           const long long *b, std::size_t n)
+{
+  const __m512i mark = _mm512_set1_epi64(wordMark);
+  const __m512i zero = _mm512_setzero_si512();
+  std::size_t marked = 0, i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    __m512i va = _mm512_loadu_si512(a + i);
+    __m512i vb = _mm512_loadu_si512(b + i);
+    __m512i s = Subtract ? _mm512_sub_epi64(va, vb) : _mm512_add_epi64(va, vb);
+    __m512i flip = _mm512_xor_si512(va, s);
+    __m512i o = _mm512_and_si512(flip, Subtract ? _mm512_xor_si512(va, vb)
+                                                : _mm512_xor_si512(vb, s));
+    __mmask8 bad = _mm512_cmplt_epi64_mask(o, zero)
+                   | _mm512_cmpeq_epi64_mask(va, mark)
+                   | _mm512_cmpeq_epi64_mask(vb, mark)
+                   | _mm512_cmpeq_epi64_mask(s, mark);
+    _mm512_storeu_si512(r + i, _mm512_mask_blend_epi64(bad, s, mark));
+    marked += __builtin_popcount(bad);
+  }
+  return marked + addWordsScalar<Subtract>(r + i, a + i, b + i, n - i);
+}
+
+__attribute__((target("avx512f")))
+std::size_t mulWordsAvx512(long long *r, const long long *a,
+                           const long long *b, std::size_t n)
+{
+  const __m512i mark = _mm512_set1_epi64(wordMark);
+  std::size_t marked = 0, i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    __m512i va = _mm512_loadu_si512(a + i);
+    __m512i vb = _mm512_loadu_si512(b + i);
+    __m512i p = _mm512_maskz_mul_epi32(0xFF, va, vb);
+    __mmask8 bad = static_cast<__mmask8>(~(fits32(va) & fits32(vb)));
+    _mm512_storeu_si512(r + i, _mm512_mask_blend_epi64(bad, p, mark));
+    marked += __builtin_popcount(bad);
+  }
+  return marked + mulWordsScalar(r + i, a + i, b + i, n - i);
+}
+
+__attribute__((target("avx512f")))
+std::size_t cmpWordsAvx512(signed char *r, const long long *a,
+                           const long long *b, std::size_t n)
+{
+  const __m512i mark = _mm512_set1_epi64(wordMark);
+  const __m512i one = _mm512_set1_epi64(1);
+  const __m512i minusOne = _mm512_set1_epi64(-1);
+  std::size_t marked = 0, i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    __m512i va = _mm512_loadu_si512(a + i);
+    __m512i vb = _mm512_loadu_si512(b + i);
+    __m512i c = _mm512_maskz_mov_epi64(_mm512_cmplt_epi64_mask(va, vb),
+                                       minusOne);
+    c = _mm512_mask_mov_epi64(c, _mm512_cmpgt_epi64_mask(va, vb), one);
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(r + i),
+                     _mm512_maskz_cvtepi64_epi8(0xFF, c));
+    marked += __builtin_popcount(_mm512_cmpeq_epi64_mask(va, mark)
+                                 | _mm512_cmpeq_epi64_mask(vb, mark));
+  }
+  return marked + cmpWordsScalar(r + i, a + i, b + i, n - i);
+}
+
+#endif // LIMB_X86
+
+// ---------------------------------------------------------
+// Dispatch
+// The kernel table starts out unset and is filled on first
+// use from the CPU features, clamped by setSimd().
+// ---------------------------------------------------------
+struct Kernels
+{
+  using WordOp = std::size_t (*)(long long *, const long long *,
+                                 const long long *, std::size_t);
+
+  int (*cmp)(const Limb *, const Limb *, std::size_t);
+  Limb (*add)(Limb *, const Limb *, const Limb *, std::size_t);
+  Limb (*sub)(Limb *, const Limb *, const Limb *, std::size_t);
+  WordOp addWords;
+  WordOp subWords;
+  WordOp mulWords;
+  std::size_t (*cmpWords)(signed char *, const long long *,
+                          const long long *, std::size_t);
+};
+
+Limb addPlain(Limb *r, const Limb *a, const Limb *b, std::size_t n)
+{
+  return addScalar(r, a, b, n, 0);
+}
+
+Limb subPlain(Limb *r, const Limb *a, const Limb *b, std::size_t n)
+{
+  return subScalar(r, a, b, n, 0);
+}
+
+const Kernels scalarKernels = {cmpScalar, addPlain, subPlain,
+                               addWordsScalar<false>, addWordsScalar<true>,
+                               mulWordsScalar, cmpWordsScalar};
+#ifdef LIMB_X86
+const Kernels avx2Kernels = {cmpAvx2, addAvx2, subAvx2,
+                             addWordsAvx2<false>, addWordsAvx2<true>,
+                             mulWordsAvx2, cmpWordsAvx2};
+const Kernels avx512Kernels = {cmpAvx512, addAvx512, subAvx512,
+                               addWordsAvx512<false>, addWordsAvx512<true>,
+                               mulWordsAvx512, cmpWordsAvx512};
+#endif
+
+Simd supported()
+{
+#ifdef LIMB_X86
+  if (__builtin_cpu_supports("avx512f"))
+    return Simd::Avx512;
+  if (__builtin_cpu_supports("avx2"))
+    return Simd::Avx2;
+#endif
+  return Simd::Scalar;
+}
+
+const Kernels *kernelsFor(Simd level)
+{
+#ifdef LIMB_X86
+  if (level == Simd::Avx512)
+    return &avx512Kernels;
+  if (level == Simd::Avx2)
+    return &avx2Kernels;
+#endif
+  (void)level;
+  return &scalarKernels;
+}
+
+std::atomic<const Kernels *> active{nullptr};
+std::atomic<Simd> activeLevel{Simd::Scalar};
+
+inline const Kernels &kernels()
+{
+  const Kernels *k = active.load(std::memory_order_relaxed);
+  if (k == nullptr)
+  {
+    // Racing first calls all store the same table.
+    Simd level = supported();
+    activeLevel.store(level, std::memory_order_relaxed);
+    k = kernelsFor(level);
+    active.store(k, std::memory_order_relaxed);
+  }
+  return *k;
+}
+
+} // namespace
+
+Simd simd()
+{
+  kernels();
+  return activeLevel.load(std::memory_order_relaxed);
+}
+
+Simd setSimd(Simd level)
+{
+  Simd best = supported();
+  if (level > best)
+    level = best;
+  activeLevel.store(level, std::memory_order_relaxed);
+  active.store(kernelsFor(level), std::memory_order_relaxed);
+  return level;
+}
+
+int cmp(const Limb *a, const Limb *b, std::size_t n)
+{
+  return kernels().cmp(a, b, n);
+}
+
+Limb add_n(Limb *r, const Limb *a, const Limb *b, std::size_t n)
+{
+  return kernels().add(r, a, b, n);
+}
+
+Limb sub_n(Limb *r, const Limb *a, const Limb *b, std::size_t n)
+{
+  return kernels().sub(r, a, b, n);
+}
+
+std::size_t add_words(long long *r, const long long *a, const long long *b,
+                      std::size_t n)
+{
+  return kernels().addWords(r, a, b, n);
+}
+
+std::size_t sub_words(long long *r, const long long *a, const long long *b,
+                      std::size_t n)
+{
+  return kernels().subWords(r, a, b, n);
+}
+
+std::size_t mul_words(long long *r, const long long *a, const long long *b,
+                      std::size_t n)
+{
+  return kernels().mulWords(r, a, b, n);
+}
+
+std::size_t cmp_words(signed char *r, const long long *a, const long long *b,
+                      std::size_t n)
+{
+  return kernels().cmpWords(r, a, b, n);
+}
+
+} // namespace limb
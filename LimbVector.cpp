@@ -0,0 +1,135 @@
+// ---------------------------------------------------------
+// File: LimbVector.cpp
+// Copy, move and growth paths of LimbVector.
+//
+// Author: agent <agent@local>
+// Last Modification: 2026-10-16
+//
+// Only spilled vectors own a block. Moving from a spilled
+// vector steals its block, allocator and all; moving from an
+// inline one copies the few limbs.
+// ---------------------------------------------------------
+
+#include "LimbVector.h"
+#include <algorithm>  // for std::copy, std::fill, std::equal, std::max
+#include <cstring>    // for std::memcpy
+
+namespace
+{
+  static_assert(sizeof(LimbAllocator *) <= sizeof(LimbVector::Limb),
+                "the block header must hold an allocator pointer");
+
+  LimbAllocator *owner(const LimbVector::Limb *data)
+  {
+    LimbAllocator *a;
+    std::memcpy(&a, data - 1, sizeof a);
+    return a;
+  }
+}
+
+LimbVector::LimbVector(size_type n, Limb x)
+{
+  reserve(n);
+  std::fill(ptr, ptr + n, x);
+  count = n;
+}
+
+LimbVector::LimbVector(const LimbVector &other)
+{
+  reserve(other.count);
+  std::copy(other.ptr, other.ptr + other.count, ptr);
+  count = other.count;
+}
+
+LimbVector::LimbVector(LimbVector &&other) noexcept
+{
+  *this = std::move(other);
+}
+
+LimbVector &LimbVector::operator=(const LimbVector &other)
+{
+  if (this != &other)
+    assign(other.begin(), other.end());
+  return *this;
+}
+
+LimbVector &LimbVector::operator=(LimbVector &&other) noexcept
+{
+  if (this == &other)
+    return *this;
+
+  if (other.isInline())
+  {
+    // Our own buffer (inline or heap) is large enough.
+    std::copy(other.local, other.local + other.count, ptr);
+    count = other.count;
+  }
+  else
+  {
+    release();
+    ptr = other.ptr;
+    cap = other.cap;
+    count = other.count;
+    other.ptr = other.local;
+    other.cap = inlineCapacity;
+  }
+  other.count = 0;
+  return *this;
+}
+
+LimbVector::~LimbVector()
+{
+  release();
+}
+
+void LimbVector::resize(size_type n)
+{
+  reserve(n);
+  if (n > count)
+    std::fill(ptr + count, ptr + n, 0);
+  count = n;
+}
+
+void LimbVector::assign(const Limb *first, const Limb *last)
+{
+  size_type n = static_cast<size_type>(last - first);
+  if (n > cap)
+  {
+    // Nothing to keep: drop the old block before allocating.
+    count = 0;
+    grow(n);
+  }
+  std::copy(first, last, ptr);
+  count = n;
+}
+
+bool LimbVector::operator==(const LimbVector &other) const
+{
+  return count == other.count
+         && std::equal(ptr, ptr + count, other.ptr);
+}
+
+// ---------------------------------------------------------
+// grow(n)
+// Geometric growth keeps push_back amortized O(1). Whatever
+// the allocator rounds the block up to becomes capacity.
+// ---------------------------------------------------------
+void LimbVector::grow(size_type n)
+{
+  LimbAllocator *a = &LimbAllocator::current();
+  size_type size = std::max(n, 2 * cap) + 1;
+  Limb *block = a->allocate(size);
+  std::memcpy(block, &a, sizeof a);
+  std::copy(ptr, ptr + count, block + 1);
+  release();
+  ptr = block + 1;
+  cap = size - 1;
+}
+
+void LimbVector::release()
+{
+  if (!isInline())
+    owner(ptr)->deallocate(ptr - 1, cap + 1);
+  ptr = local;
+  cap = inlineCapacity;
+}
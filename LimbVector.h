@@ -0,0 +1,124 @@
+// ---------------------------------------------------------
+// File: LimbVector.h
+// Limb storage for Integer with a small inline buffer.
+//
+// Author: agent <agent@local>
+// Last Modification: 2026-10-16
+//
+// Up to inlineCapacity limbs live inside the object itself;
+// longer magnitudes spill to a block from the calling thread's
+// LimbAllocator. Values of one or two machine words are
+// therefore created, copied and combined without touching the
+// allocator. The interface is the subset of std::vector that
+// Integer needs.
+// ---------------------------------------------------------
+
+#ifndef LIMB_VECTOR_H
+#define LIMB_VECTOR_H
+
+#include "LimbAllocator.h"
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+// ---------------------------------------------------------
+// Class: LimbVector
+// Contiguous, growable array of 64-bit limbs. data() always
+// points either at the inline buffer or just past the header
+// limb of a block of capacity() + 1 limbs; the header records
+// the allocator the block came from. Newly exposed limbs are
+// zero-filled. Also serves as the scratch array of the limb
+// kernels, so their temporaries come from the same allocator.
+// ---------------------------------------------------------
+class LimbVector
+{
+public:
+  using Limb = std::uint64_t;
+  using size_type = std::size_t;
+
+  // Limbs stored without a heap allocation.
+  static constexpr size_type inlineCapacity = 2;
+
+  LimbVector() = default;
+  // n zero limbs.
+  explicit LimbVector(size_type n) { resize(n); }
+  // n copies of x.
+  LimbVector(size_type n, Limb x);
+  // The limbs in [first,last), or in the list.
+  LimbVector(const Limb *first, const Limb *last) { assign(first, last); }
+  LimbVector(std::initializer_list<Limb> limbs)
+  { assign(limbs.begin(), limbs.end()); }
+  LimbVector(const LimbVector &other);
+  LimbVector(LimbVector &&other) noexcept;
+  LimbVector &operator=(const LimbVector &other);
+  LimbVector &operator=(LimbVector &&other) noexcept;
+  ~LimbVector();
+
+  size_type size() const { return count; }
+  size_type capacity() const { return cap; }
+  bool empty() const { return count == 0; }
+  bool isInline() const { return ptr == local; }
+
+  Limb *data() { return ptr; }
+  const Limb *data() const { return ptr; }
+  Limb &operator[](size_type i) { return ptr[i]; }
+  const Limb &operator[](size_type i) const { return ptr[i]; }
+  Limb &back() { return ptr[count-1]; }
+  const Limb &back() const { return ptr[count-1]; }
+
+  Limb *begin() { return ptr; }
+  Limb *end() { return ptr + count; }
+  const Limb *begin() const { return ptr; }
+  const Limb *end() const { return ptr + count; }
+
+  void clear() { count = 0; }
+  void pop_back() { --count; }
+
+  void push_back(Limb x)
+  {
+    if (count == cap)
+      grow(count + 1);
+    ptr[count++] = x;
+  }
+
+  // -------------------------------------------------------
+  // reserve(n)
+  // Ensures capacity() >= n; keeps the contents.
+  // -------------------------------------------------------
+  void reserve(size_type n)
+  {
+    if (n > cap)
+      grow(n);
+  }
+
+  // -------------------------------------------------------
+  // resize(n)
+  // Changes size to n; limbs past the old size become 0.
+  // -------------------------------------------------------
+  void resize(size_type n);
+
+  // -------------------------------------------------------
+  // assign(first,last)
+  // Replaces the contents with the limbs in [first,last).
+  // -------------------------------------------------------
+  void assign(const Limb *first, const Limb *last);
+
+  bool operator==(const LimbVector &other) const;
+  bool operator!=(const LimbVector &other) const
+  { return !(*this == other); }
+
+private:
+  Limb *ptr = local;
+  size_type count = 0;
+  size_type cap = inlineCapacity;
+  Limb local[inlineCapacity];
+
+  // Moves the contents to an allocated block of at least n
+  // limbs.
+  void grow(size_type n);
+
+  // Returns the block to its allocator, if any.
+  void release();
+};
+
+#endif // LIMB_VECTOR_H
@@ -0,0 +1,64 @@
+// ---------------------------------------------------------
+// File: Modulus.h
+// Precomputed modulus for repeated modular arithmetic.
+//
+// Author: agent <agent@local>
+// Last Modification: 2026-10-16
+//
+// A Modulus prepares m once: the Barrett reciprocal
+// floor((2^128n - 1) / m) for every m and, for odd m, the
+// Montgomery constants -m^-1 mod 2^64n and 2^128n mod m (n
+// being the limb count of m). Each reduction then costs about
+// two multiplications instead of a division. pow() works in
+// Montgomery form when m is odd, with Barrett reduction
+// otherwise, and scans the exponent with a sliding window.
+// Building a Modulus costs about one division; keep it around
+// when the same modulus is used more than once:
+//
+//   Modulus mod(p);
+//   for (const Integer &x : xs)
+//     ys.push_back(mod.pow(x, e));
+//
+// A Modulus is cheap to copy (the constants are shared) and
+// may be used from several threads at once.
+// ---------------------------------------------------------
+
+#ifndef MODULUS_H
+#define MODULUS_H
+
+#include "Integer.h"
+#include <cstddef>
+#include <memory>
+
+class Modulus
+{
+public:
+    // Prepares the modulus m. Throws std::domain_error unless
+    // m > 0.
+    explicit Modulus(const Integer &m);
+
+    // Returns m.
+    const Integer &value() const;
+
+    // Returns x mod m in [0, m), also for negative x.
+    Integer reduce(const Integer &x) const;
+
+    // Returns a * b mod m and a^2 mod m in [0, m).
+    Integer multiply(const Integer &a, const Integer &b) const;
+    Integer square(const Integer &a) const;
+
+    // Returns base^exp mod m in [0, m); base may be negative and
+    // base^0 is 1 mod m. Throws std::domain_error if exp < 0.
+    Integer pow(const Integer &base, const Integer &exp) const;
+
+private:
+    struct Context;
+
+    // Integer with the magnitude a[0..n) (not necessarily
+    // normalized).
+    static Integer fromLimbs(const Integer::Limb *a, std::size_t n);
+
+    std::shared_ptr<const Context> context;
+};
+
+#endif // MODULUS_H
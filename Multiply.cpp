@@ -0,0 +1,421 @@
+// ---------------------------------------------------------
+// File: Multiply.cpp
+// Multiplication algorithms for limb arrays and the
+// size-based dispatcher behind Integer::operator*.
+//
+// Author: agent <agent@local>
+// Last Modification: 2026-10-16
+//
+// Schoolbook for small operands, Karatsuba and Toom-3 for
+// balanced ones, a slicing strategy for unbalanced ones, and
+// the NTT engine (NTT.cpp) above all of them; sqr() mirrors
+// the balanced ones for squares. Products of at least
+// Integer::multiplyThresholds().parallel limbs run their
+// independent sub-products on the thread pool (ThreadPool.h).
+// Scratch space is held in LimbVectors, so the recursion
+// recycles blocks through the thread's LimbAllocator.
+// ---------------------------------------------------------
+
+#include "Limb.h"
+#include "ThreadPool.h"
+#include <algorithm>  // for std::max, std::min, std::fill
+
+namespace limb
+{
+
+namespace
+{
+
+// ---------------------------------------------------------
+// SignedLimbs
+// Signed scratch value used by the Toom-3 interpolation.
+// ---------------------------------------------------------
+struct SignedLimbs
+{
+  LimbVector mag;
+  bool neg = false;
+};
+
+SignedLimbs fromSpan(const Limb *a, std::size_t n)
+{
+  SignedLimbs r;
+  r.mag.assign(a, a + normalizedSize(a, n));
+  return r;
+}
+
+void trim(SignedLimbs &x)
+{
+  x.mag.resize(normalizedSize(x.mag.data(), x.mag.size()));
+  if (x.mag.empty())
+    x.neg = false;
+}
+
+// ---------------------------------------------------------
+// addSigned(x,y,negateY)
+// Returns x + y, or x - y when negateY is set.
+// ---------------------------------------------------------
+SignedLimbs addSigned(const SignedLimbs &x, const SignedLimbs &y,
+                      bool negateY = false)
+{
+  bool yneg = y.neg != negateY;
+  const auto &xm = x.mag, &ym = y.mag;
+  SignedLimbs r;
+
+  if (x.neg == yneg)
+  {
+    const auto &big = xm.size() >= ym.size() ? xm : ym;
+    const auto &small = xm.size() >= ym.size() ? ym : xm;
+    r.mag.resize(big.size() + 1);
+    r.mag[big.size()] = add(r.mag.data(), big.data(), big.size(),
+                            small.data(), small.size());
+    r.neg = x.neg;
+  }
+  else
+  {
+    int c = xm.size() != ym.size()
+              ? (xm.size() < ym.size() ? -1 : 1)
+              : cmp(xm.data(), ym.data(), xm.size());
+    const auto &big = c >= 0 ? xm : ym;
+    const auto &small = c >= 0 ? ym : xm;
+    r.mag.resize(big.size());
+    sub(r.mag.data(), big.data(), big.size(), small.data(), small.size());
+    r.neg = c >= 0 ? x.neg : yneg;
+  }
+  trim(r);
+  return r;
+}
+
+SignedLimbs mulSigned(const SignedLimbs &x, const SignedLimbs &y)
+{
+  SignedLimbs r;
+  if (x.mag.empty() || y.mag.empty())
+    return r;
+  const auto &big = x.mag.size() >= y.mag.size() ? x.mag : y.mag;
+  const auto &small = x.mag.size() >= y.mag.size() ? y.mag : x.mag;
+  r.mag.resize(big.size() + small.size());
+  mul(r.mag.data(), big.data(), big.size(), small.data(), small.size());
+  r.neg = x.neg != y.neg;
+  trim(r);
+  return r;
+}
+
+SignedLimbs sqrSigned(const SignedLimbs &x)
+{
+  SignedLimbs r;
+  if (x.mag.empty())
+    return r;
+  r.mag.resize(2 * x.mag.size());
+  sqr(r.mag.data(), x.mag.data(), x.mag.size());
+  trim(r);
+  return r;
+}
+
+// In-place exact division of the magnitude by 3, using the
+// inverse of 3 modulo 2^64.
+void divexactBy3(SignedLimbs &x)
+{
+  const Limb inv3 = 0xAAAAAAAAAAAAAAABULL;
+  Limb c = 0;
+  for (auto &limb : x.mag)
+  {
+    Limb s = limb;
+    Limb t = s - c;
+    c = s < c;
+    Limb q = t * inv3;
+    limb = q;
+    c += static_cast<Limb>((static_cast<DoubleLimb>(q) * 3) >> 64);
+  }
+  trim(x);
+}
+
+// In-place exact halving of the magnitude.
+void halve(SignedLimbs &x)
+{
+  auto &m = x.mag;
+  for (std::size_t i = 0; i < m.size(); ++i)
+  {
+    Limb hi = i + 1 < m.size() ? m[i+1] : 0;
+    m[i] = (m[i] >> 1) | (hi << 63);
+  }
+  trim(x);
+}
+
+// ---------------------------------------------------------
+// absDiff(r,x,xn,y,yn)
+// r[0..xn) = |x - y|. Preconditions: xn >= yn.
+// Returns true if x < y.
+// ---------------------------------------------------------
+bool absDiff(Limb *r, const Limb *x, std::size_t xn,
+             const Limb *y, std::size_t yn)
+{
+  bool less = normalizedSize(x + yn, xn - yn) == 0
+              && cmp(x, y, yn) < 0;
+  if (less)
+  {
+    sub_n(r, y, x, yn);
+    std::fill(r + yn, r + xn, 0);
+  }
+  else
+  {
+    sub(r, x, xn, y, yn);
+  }
+  return less;
+}
+
+// ---------------------------------------------------------
+// karatsuba(r,a,an,b,bn)
+// Splits both operands at h = ceil(an/2) and forms the middle
+// coefficient as z0 + z2 -/+ |a0-a1|*|b1-b0|.
+// Preconditions: an >= bn > ceil(an/2).
+// ---------------------------------------------------------
+void karatsuba(Limb *r, const Limb *a, std::size_t an,
+               const Limb *b, std::size_t bn)
+{
+  std::size_t h = (an + 1) / 2;
+  std::size_t a1n = an - h, b1n = bn - h;
+  std::size_t rn = an + bn;
+
+  LimbVector scratch(4*h + 1);
+  Limb *da = scratch.data(), *db = da + h, *t = db + h;
+  bool aless = absDiff(da, a, h, a + h, a1n);
+  bool bless = absDiff(db, b, h, b + h, b1n);
+
+  // z0 = a0*b0 in r[0..2h), z2 = a1*b1 in r[2h..rn) and
+  // m = |a0-a1|*|b0-b1|.
+  LimbVector m(2*h);
+  parallelInvoke(bn, [&] { mul(r, a, h, b, h); },
+                     [&] { mul(r + 2*h, a + h, a1n, b + h, b1n); },
+                     [&] { mul(m.data(), da, h, db, h); });
+
+  // t = z0 + z2, then fold in (a0-a1)(b0-b1) with its sign.
+  t[2*h] = add(t, r, 2*h, r + 2*h, rn - 2*h);
+  if (aless != bless)
+    t[2*h] += add_n(t, t, m.data(), 2*h);
+  else
+    t[2*h] -= sub_n(t, t, m.data(), 2*h);
+
+  std::size_t tn = normalizedSize(t, 2*h + 1);
+  add(r + h, r + h, rn - h, t, tn);
+}
+
+// ---------------------------------------------------------
+// karatsubaSquare(r,a,n)
+// a^2 = z0 + (z0 + z2 - |a0-a1|^2) B^h + z2 B^2h: three
+// squares, and the middle term is never negative.
+// Preconditions: n >= 2.
+// ---------------------------------------------------------
+void karatsubaSquare(Limb *r, const Limb *a, std::size_t n)
+{
+  std::size_t h = (n + 1) / 2;
+  std::size_t a1n = n - h;
+
+  LimbVector scratch(3*h + 1);
+  Limb *da = scratch.data(), *t = da + h;
+  absDiff(da, a, h, a + h, a1n);
+
+  LimbVector m(2*h);
+  parallelInvoke(n, [&] { sqr(r, a, h); },
+                    [&] { sqr(r + 2*h, a + h, a1n); },
+                    [&] { sqr(m.data(), da, h); });
+
+  t[2*h] = add(t, r, 2*h, r + 2*h, 2*n - 2*h);
+  t[2*h] -= sub_n(t, t, m.data(), 2*h);
+
+  std::size_t tn = normalizedSize(t, 2*h + 1);
+  add(r + h, r + h, 2*n - h, t, tn);
+}
+
+// ---------------------------------------------------------
+// Toom-3 evaluation and interpolation
+// Toom-Cook 3-way with evaluation points 0, 1, -1, -2, inf
+// and Bodrato's interpolation sequence. A polynomial's values
+// at 0 and inf are its outer pieces.
+// ---------------------------------------------------------
+struct Toom3Values
+{
+  SignedLimbs p0, p1, pm1, pm2, pinf;
+};
+
+Toom3Values toom3Evaluate(const Limb *a, std::size_t an, std::size_t k)
+{
+  auto piece = [k](const Limb *p, std::size_t n, std::size_t i) {
+    std::size_t lo = std::min(n, i * k);
+    std::size_t hi = std::min(n, lo + k);
+    return fromSpan(p + lo, hi - lo);
+  };
+  Toom3Values v;
+  v.p0 = piece(a, an, 0);
+  SignedLimbs a1 = piece(a, an, 1);
+  v.pinf = piece(a, an, 2);
+
+  SignedLimbs t = addSigned(v.p0, v.pinf);
+  v.p1 = addSigned(t, a1);
+  v.pm1 = addSigned(t, a1, true);
+  v.pm2 = addSigned(v.pm1, v.pinf);
+  v.pm2 = addSigned(addSigned(v.pm2, v.pm2), v.p0, true);
+  return v;
+}
+
+// r[0..rn) from the products at 0, 1, -1, -2 and inf.
+void toom3Interpolate(Limb *r, std::size_t rn, std::size_t k,
+                      SignedLimbs &c0, SignedLimbs &r1, SignedLimbs &rm1,
+                      SignedLimbs &rm2, SignedLimbs &c4)
+{
+  SignedLimbs c3 = addSigned(rm2, r1, true);
+  divexactBy3(c3);
+  SignedLimbs c1 = addSigned(r1, rm1, true);
+  halve(c1);
+  SignedLimbs c2 = addSigned(rm1, c0, true);
+  c3 = addSigned(c2, c3, true);
+  halve(c3);
+  c3 = addSigned(c3, addSigned(c4, c4));
+  c2 = addSigned(addSigned(c2, c1), c4, true);
+  c1 = addSigned(c1, c3, true);
+
+  // Recompose; every coefficient is non-negative here.
+  std::fill(r, r + rn, 0);
+  const SignedLimbs *coeffs[] = {&c0, &c1, &c2, &c3, &c4};
+  for (std::size_t i = 0; i < 5; ++i)
+  {
+    const auto &c = coeffs[i]->mag;
+    if (!c.empty())
+      add(r + i*k, r + i*k, rn - i*k, c.data(), c.size());
+  }
+}
+
+// ---------------------------------------------------------
+// toom3(r,a,an,b,bn)
+// Preconditions: an >= bn > 2*ceil(an/3).
+// ---------------------------------------------------------
+void toom3(Limb *r, const Limb *a, std::size_t an,
+           const Limb *b, std::size_t bn)
+{
+  std::size_t k = (an + 2) / 3;
+  Toom3Values x = toom3Evaluate(a, an, k);
+  Toom3Values y = toom3Evaluate(b, bn, k);
+
+  SignedLimbs c0, r1, rm1, rm2, c4;
+  parallelInvoke(bn, [&] { c0 = mulSigned(x.p0, y.p0); },
+                     [&] { r1 = mulSigned(x.p1, y.p1); },
+                     [&] { rm1 = mulSigned(x.pm1, y.pm1); },
+                     [&] { rm2 = mulSigned(x.pm2, y.pm2); },
+                     [&] { c4 = mulSigned(x.pinf, y.pinf); });
+  toom3Interpolate(r, an + bn, k, c0, r1, rm1, rm2, c4);
+}
+
+// ---------------------------------------------------------
+// toom3Square(r,a,n)
+// toom3() with one evaluation and five squares.
+// ---------------------------------------------------------
+void toom3Square(Limb *r, const Limb *a, std::size_t n)
+{
+  std::size_t k = (n + 2) / 3;
+  Toom3Values x = toom3Evaluate(a, n, k);
+
+  SignedLimbs c0, r1, rm1, rm2, c4;
+  parallelInvoke(n, [&] { c0 = sqrSigned(x.p0); },
+                    [&] { r1 = sqrSigned(x.p1); },
+                    [&] { rm1 = sqrSigned(x.pm1); },
+                    [&] { rm2 = sqrSigned(x.pm2); },
+                    [&] { c4 = sqrSigned(x.pinf); });
+  toom3Interpolate(r, 2*n, k, c0, r1, rm1, rm2, c4);
+}
+
+// ---------------------------------------------------------
+// mulUnbalanced(r,a,an,b,bn)
+// Slices a into bn-limb blocks and accumulates each block
+// product, so every sub-multiplication is balanced.
+// ---------------------------------------------------------
+void mulUnbalanced(Limb *r, const Limb *a, std::size_t an,
+                   const Limb *b, std::size_t bn)
+{
+  std::size_t rn = an + bn;
+  std::fill(r, r + rn, 0);
+
+  std::size_t blocks = (an + bn - 1) / bn;
+  if (blocks > 2 && useParallel(bn))
+  {
+    // Block k's product spans [k*bn, k*bn + 2*bn), so the even
+    // blocks never overlap each other, nor do the odd ones:
+    // each set is written concurrently, then the sets are added.
+    LimbVector odd(rn);
+    parallelRange(bn, blocks, 1, [&](std::size_t lo, std::size_t hi) {
+      for (std::size_t k = lo; k < hi; ++k)
+      {
+        std::size_t off = k * bn, cn = std::min(bn, an - off);
+        Limb *dst = (k % 2 ? odd.data() : r) + off;
+        if (cn == bn)
+          mul(dst, a + off, cn, b, bn);
+        else
+          mul(dst, b, bn, a + off, cn);
+      }
+    });
+    add_n(r, r, odd.data(), rn);
+    return;
+  }
+
+  LimbVector tmp(2*bn);
+
+  for (std::size_t off = 0; off < an; off += bn)
+  {
+    std::size_t cn = std::min(bn, an - off);
+    if (cn == bn)
+      mul(tmp.data(), a + off, cn, b, bn);
+    else
+      mul(tmp.data(), b, bn, a + off, cn);
+    add(r + off, r + off, rn - off, tmp.data(), cn + bn);
+  }
+}
+
+} // namespace
+
+void mul(Limb *r, const Limb *a, std::size_t an,
+         const Limb *b, std::size_t bn)
+{
+  const auto &t = Integer::multiplyThresholds();
+  // Enters the thread pool for a large enough top-level call.
+  ParallelScope scope(bn);
+  // Clamp so the recursive splits always shrink.
+  std::size_t kara = std::max<std::size_t>(t.karatsuba, 2);
+  std::size_t toom = std::max<std::size_t>(t.toom3, 6);
+
+  if (bn < kara)
+    mul_basecase(r, a, an, b, bn);
+  else if (bn >= t.ntt)
+    mul_ntt(r, a, an, b, bn);
+  else if (bn <= (an + 1) / 2)
+    mulUnbalanced(r, a, an, b, bn);
+  else if (bn >= toom && bn > 2 * ((an + 2) / 3))
+    toom3(r, a, an, b, bn);
+  else
+    karatsuba(r, a, an, b, bn);
+}
+
+void sqr(Limb *r, const Limb *a, std::size_t n)
+{
+  const auto &t = Integer::multiplyThresholds();
+  ParallelScope scope(n);
+  std::size_t kara = std::max<std::size_t>(t.squareKaratsuba, 2);
+  std::size_t toom = std::max<std::size_t>(t.squareToom3, 6);
+
+  if (n < kara)
+    sqr_basecase(r, a, n);
+  else if (n >= t.squareNtt)
+    mul_ntt(r, a, n, a, n);
+  else if (n >= toom)
+    toom3Square(r, a, n);
+  else
+    karatsubaSquare(r, a, n);
+}
+
+} // namespace limb
+
+// ---------------------------------------------------------
+// multiplyThresholds()
+// Process-wide algorithm crossover points, in limbs.
+// ---------------------------------------------------------
+Integer::MultiplyThresholds &Integer::multiplyThresholds()
+{
+  static MultiplyThresholds thresholds;
+  return thresholds;
+}
@@ -0,0 +1,374 @@
+// ---------------------------------------------------------
+// File: NTT.cpp
+// Number-theoretic transform multiplication for very large
+// limb arrays.
+//
+// Author: agent <agent@local>
+// Last Modification: 2026-10-16
+//
+// Each operand limb is one coefficient. The cyclic convolution
+// is computed modulo three 62-bit primes of the form c*2^k+1
+// in Montgomery arithmetic and recombined exactly with Garner's
+// CRT. With p1*p2*p3 > 2^185 and coefficients below
+// N*2^128 the result is exact for any N <= 2^42.
+//
+// Above Integer::multiplyThresholds().parallel limbs the three
+// primes, the butterflies of each stage and the recombination
+// are split across the thread pool (ThreadPool.h).
+// ---------------------------------------------------------
+
+#include "Limb.h"
+#include "ThreadPool.h"
+#include <algorithm>  // for std::fill, std::min
+#include <vector>
+
+namespace limb
+{
+
+namespace
+{
+
+// ---------------------------------------------------------
+// Montgomery
+// Arithmetic modulo an odd prime p < 2^62 with R = 2^64.
+// mul(a,b) returns a*b/R mod p; values stay in [0,p).
+// ---------------------------------------------------------
+class Montgomery
+{
+public:
+  explicit Montgomery(Limb modulus)
+    : p(modulus)
+  {
+    Limb inv = p;                   // correct to 3 bits for odd p
+    for (int i = 0; i < 5; ++i)
+      inv *= 2 - p * inv;
+    pinv = 0 - inv;
+
+    Limb r = static_cast<Limb>((static_cast<DoubleLimb>(1) << 64) % p);
+    r2 = static_cast<Limb>(static_cast<DoubleLimb>(r) * r % p);
+  }
+
+  Limb modulus() const { return p; }
+
+  Limb reduce(DoubleLimb t) const
+  {
+    Limb m = static_cast<Limb>(t) * pinv;
+    Limb u = static_cast<Limb>((t + static_cast<DoubleLimb>(m) * p) >> 64);
+    return u >= p ? u - p : u;
+  }
+
+  Limb mul(Limb a, Limb b) const
+  { return reduce(static_cast<DoubleLimb>(a) * b); }
+
+  Limb add(Limb a, Limb b) const
+  { Limb s = a + b; return s >= p ? s - p : s; }
+
+  Limb sub(Limb a, Limb b) const
+  { return a >= b ? a - b : a + p - b; }
+
+  // Any 64-bit a works: a*r2 < p*R keeps reduce() in range.
+  Limb toMont(Limb a) const { return mul(a, r2); }
+  Limb fromMont(Limb a) const { return reduce(a); }
+
+  // a^e for a in Montgomery form; result in Montgomery form.
+  Limb pow(Limb a, Limb e) const
+  {
+    Limb r = toMont(1);
+    while (e)
+    {
+      if (e & 1)
+        r = mul(r, a);
+      a = mul(a, a);
+      e >>= 1;
+    }
+    return r;
+  }
+
+  // Plain-form inverse of a plain-form value (p prime).
+  Limb inverse(Limb a) const
+  { return fromMont(pow(toMont(a), p - 2)); }
+
+private:
+  Limb p;
+  Limb pinv;   // -p^{-1} mod 2^64
+  Limb r2;     // R^2 mod p
+};
+
+struct Prime
+{
+  Limb p;
+  Limb generator;
+};
+
+const Prime PRIMES[3] = {
+  {0x3fffc00000000001ULL, 11},   // 65535 * 2^46 + 1
+  {0x3fff840000000001ULL, 19},   // 1048545 * 2^42 + 1
+  {0x3fff540000000001ULL, 5},    // 1048533 * 2^42 + 1
+};
+
+// Butterflies, or coefficients, per parallel task.
+const std::size_t GRAIN = 1 << 14;
+
+// ---------------------------------------------------------
+// Transform
+// Radix-2 NTT of one fixed size modulo one prime. Twiddles
+// for the stage with half-length len are stored at
+// roots[len .. 2*len). work is the size of the product's
+// shorter operand, which decides whether loops run in
+// parallel.
+// ---------------------------------------------------------
+class Transform
+{
+public:
+  Transform(const Prime &prime, std::size_t n, std::size_t limbs)
+    : mont(prime.p), size(n), work(limbs), roots(n), invRoots(n)
+  {
+    Limb g = mont.toMont(prime.generator);
+    Limb w = mont.pow(g, (prime.p - 1) / n);
+    Limb wInv = mont.pow(w, prime.p - 2);
+    fillRoots(roots, w);
+    fillRoots(invRoots, wInv);
+    nInv = mont.inverse(static_cast<Limb>(n % prime.p));
+  }
+
+  // Load limbs as residues in Montgomery form, zero padded.
+  void load(std::vector<Limb> &out, const Limb *a, std::size_t an) const
+  {
+    out.assign(size, 0);
+    parallelRange(work, an, GRAIN, [&](std::size_t lo, std::size_t hi) {
+      const Montgomery m = mont;
+      for (std::size_t i = lo; i < hi; ++i)
+        out[i] = m.toMont(a[i]);
+    });
+  }
+
+  // Decimation in frequency: natural order in, bit-reversed out.
+  void forward(std::vector<Limb> &a) const
+  {
+    for (std::size_t len = size / 2; len >= 1; len /= 2)
+    {
+      const Limb *w = roots.data() + len;
+      stage(len, [&](std::size_t i, std::size_t j0, std::size_t j1) {
+        // Local copies: stores to x cannot alias them.
+        const Montgomery m = mont;
+        Limb *x = a.data() + i, *y = x + len;
+        for (std::size_t j = j0; j < j1; ++j)
+        {
+          Limb u = x[j], v = y[j];
+          x[j] = m.add(u, v);
+          y[j] = m.mul(m.sub(u, v), w[j]);
+        }
+      });
+    }
+  }
+
+  // Decimation in time: bit-reversed in, natural order out.
+  // Leaves results scaled by 1/n and in plain form.
+  void inverse(std::vector<Limb> &a) const
+  {
+    for (std::size_t len = 1; len < size; len *= 2)
+    {
+      const Limb *w = invRoots.data() + len;
+      stage(len, [&](std::size_t i, std::size_t j0, std::size_t j1) {
+        const Montgomery m = mont;
+        Limb *x = a.data() + i, *y = x + len;
+        for (std::size_t j = j0; j < j1; ++j)
+        {
+          Limb u = x[j], v = m.mul(y[j], w[j]);
+          x[j] = m.add(u, v);
+          y[j] = m.sub(u, v);
+        }
+      });
+    }
+    parallelRange(work, size, GRAIN, [&](std::size_t lo, std::size_t hi) {
+      const Montgomery m = mont;
+      Limb scale = nInv;
+      for (std::size_t i = lo; i < hi; ++i)
+        a[i] = m.mul(a[i], scale);
+    });
+  }
+
+  void pointwise(std::vector<Limb> &a, const std::vector<Limb> &b) const
+  {
+    parallelRange(work, size, GRAIN, [&](std::size_t lo, std::size_t hi) {
+      const Montgomery m = mont;
+      for (std::size_t i = lo; i < hi; ++i)
+        a[i] = m.mul(a[i], b[i]);
+    });
+  }
+
+private:
+  // -------------------------------------------------------
+  // stage(len,body)
+  // Visits the size/2 butterflies of one stage, numbered
+  // block by block, as body(i,j0,j1) for the butterflies
+  // (i+j, i+j+len) with j in [j0,j1). Ranges of butterflies
+  // go to separate tasks when the product is large enough.
+  // -------------------------------------------------------
+  template <typename Body>
+  void stage(std::size_t len, Body body) const
+  {
+    parallelRange(work, size / 2, GRAIN,
+                  [&](std::size_t lo, std::size_t hi) {
+      std::size_t i = lo / len * 2 * len, j0 = lo % len;
+      for (std::size_t k = lo; k < hi; i += 2 * len, j0 = 0)
+      {
+        std::size_t j1 = std::min(len, j0 + (hi - k));
+        body(i, j0, j1);
+        k += j1 - j0;
+      }
+    });
+  }
+
+  void fillRoots(std::vector<Limb> &table, Limb w) const
+  {
+    // w has order n; the stage with half-length len needs
+    // powers of a root of order 2*len, i.e. w^(n/(2*len)).
+    for (std::size_t len = size / 2; len >= 1; len /= 2)
+    {
+      Limb step = mont.pow(w, size / (2*len));
+      Limb cur = mont.toMont(1);
+      for (std::size_t j = 0; j < len; ++j)
+      {
+        table[len + j] = cur;
+        cur = mont.mul(cur, step);
+      }
+    }
+  }
+
+  Montgomery mont;
+  std::size_t size;
+  std::size_t work;
+  std::vector<Limb> roots;
+  std::vector<Limb> invRoots;
+  Limb nInv;
+};
+
+// ---------------------------------------------------------
+// Garner
+// Constants for reconstructing x mod p1*p2*p3 from residues.
+// ---------------------------------------------------------
+struct Garner
+{
+  Montgomery m2{PRIMES[1].p};
+  Montgomery m3{PRIMES[2].p};
+  Limb p1 = PRIMES[0].p;
+  DoubleLimb p1p2 = static_cast<DoubleLimb>(PRIMES[0].p) * PRIMES[1].p;
+  Limb inv12 = m2.toMont(m2.inverse(p1 % m2.modulus()));
+  Limb p1Mod3 = m3.toMont(p1 % m3.modulus());
+  Limb inv123 = m3.toMont(m3.inverse(
+    static_cast<Limb>(p1p2 % m3.modulus())));
+
+  // Writes x = x1 + p1*t2 + p1*p2*t3 as three limbs.
+  void combine(Limb x1, Limb x2, Limb x3, Limb out[3]) const
+  {
+    // p1 < 2*p2 and p1, p2 < 2*p3, so one subtraction reduces.
+    Limb x1m2 = x1 >= m2.modulus() ? x1 - m2.modulus() : x1;
+    Limb x1m3 = x1 >= m3.modulus() ? x1 - m3.modulus() : x1;
+    Limb t2 = m2.mul(m2.sub(x2, x1m2), inv12);
+    Limb y = m3.add(m3.mul(t2, p1Mod3), x1m3);
+    Limb t3 = m3.mul(m3.sub(x3, y), inv123);
+
+    DoubleLimb v = static_cast<DoubleLimb>(p1) * t2 + x1;
+    DoubleLimb lo = static_cast<DoubleLimb>(static_cast<Limb>(p1p2)) * t3;
+    DoubleLimb hi = static_cast<DoubleLimb>(static_cast<Limb>(p1p2 >> 64)) * t3;
+    DoubleLimb mid = (lo >> 64) + static_cast<Limb>(hi);
+
+    Limb w[3] = {static_cast<Limb>(lo), static_cast<Limb>(mid),
+                 static_cast<Limb>((hi >> 64) + (mid >> 64))};
+    Limb vv[2] = {static_cast<Limb>(v), static_cast<Limb>(v >> 64)};
+    add(out, w, 3, vv, 2);  // x < p1*p2*p3 < 2^192, no carry out
+  }
+};
+
+// ---------------------------------------------------------
+// recombine(r,residues,s,e,outLen)
+// Writes sum of the coefficients i in [s,e) times B^(i-s) to
+// r[0..outLen), carrying through a three-limb accumulator.
+// Coefficient i exists for i < count.
+// ---------------------------------------------------------
+void recombine(Limb *r, const std::vector<Limb> residues[3],
+               std::size_t count, std::size_t s, std::size_t e,
+               std::size_t outLen)
+{
+  static const Garner garner;
+  Limb acc[4] = {0, 0, 0, 0};
+  for (std::size_t i = s; i < s + outLen; ++i)
+  {
+    if (i < e && i < count)
+    {
+      Limb x[3];
+      garner.combine(residues[0][i], residues[1][i], residues[2][i], x);
+      acc[3] += add_n(acc, acc, x, 3);
+    }
+    r[i - s] = acc[0];
+    acc[0] = acc[1];
+    acc[1] = acc[2];
+    acc[2] = acc[3];
+    acc[3] = 0;
+  }
+}
+
+} // namespace
+
+void mul_ntt(Limb *r, const Limb *a, std::size_t an,
+             const Limb *b, std::size_t bn)
+{
+  std::size_t rn = an + bn;
+  std::size_t n = 1;
+  while (n < rn - 1)
+    n *= 2;
+
+  bool square = a == b && an == bn;
+  std::vector<Limb> residues[3];
+  auto convolve = [&](int k) {
+    Transform t(PRIMES[k], n, bn);
+    if (square)
+    {
+      t.load(residues[k], a, an);
+      t.forward(residues[k]);
+      t.pointwise(residues[k], residues[k]);
+      t.inverse(residues[k]);
+      return;
+    }
+    std::vector<Limb> fb;
+    parallelInvoke(bn, [&] { t.load(residues[k], a, an); },
+                       [&] { t.load(fb, b, bn); });
+    parallelInvoke(bn, [&] { t.forward(residues[k]); },
+                       [&] { t.forward(fb); });
+    t.pointwise(residues[k], fb);
+    t.inverse(residues[k]);
+  };
+  parallelInvoke(bn, [&] { convolve(0); }, [&] { convolve(1); },
+                     [&] { convolve(2); });
+
+  // Recombine coefficients. In parallel, each chunk is summed
+  // on its own (three limbs longer than the chunk) and the
+  // overlapping partial sums are added afterwards.
+  std::size_t count = rn - 1;
+  if (count <= GRAIN || !useParallel(bn))
+  {
+    recombine(r, residues, count, 0, count, rn);
+    return;
+  }
+  std::size_t chunks = (count + GRAIN - 1) / GRAIN;
+  std::vector<std::vector<Limb>> parts(chunks);
+  parallelRange(bn, chunks, 1, [&](std::size_t lo, std::size_t hi) {
+    for (std::size_t c = lo; c < hi; ++c)
+    {
+      std::size_t s = c * GRAIN, e = std::min(count, s + GRAIN);
+      parts[c].resize(std::min(e - s + 3, rn - s));
+      recombine(parts[c].data(), residues, count, s, e, parts[c].size());
+    }
+  });
+  std::fill(r, r + rn, 0);
+  for (std::size_t c = 0; c < chunks; ++c)
+  {
+    std::size_t s = c * GRAIN, m = parts[c].size();
+    Limb carry = add_n(r + s, r + s, parts[c].data(), m);
+    for (std::size_t i = s + m; carry && i < rn; ++i)
+      carry = ++r[i] == 0;
+  }
+}
+
+} // namespace limb
@@ -0,0 +1,445 @@
+// ---------------------------------------------------------
+// File: Power.cpp
+// Powers and modular powers of Integers.
+//
+// Author: agent <agent@local>
+// Last Modification: 2026-10-16
+//
+// Both pow() and Modulus::pow() scan the exponent from the top
+// with a sliding window of up to k bits, k growing with the
+// exponent length: a table of the odd powers x^1, x^3, ...,
+// x^(2^k - 1) turns each window into one multiplication.
+//
+// Modular powers never leave n limbs (n the size of m).
+// Odd moduli work in Montgomery form, x R mod m with R = B^n,
+// where reducing a 2n-limb product needs no division: REDC
+// adds the multiple q*m of m that clears the low n limbs and
+// drops them, one limb of q at a time in schoolbook range or
+// as two n-limb products above it. Even moduli, and single
+// products, use Barrett reduction with the precomputed
+// reciprocal mu = floor((B^2n - 1) / m).
+// ---------------------------------------------------------
+
+#include "Modulus.h"
+#include "Limb.h"
+#include <algorithm>  // for std::copy, std::fill
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace limb
+{
+
+namespace
+{
+
+using Nat = LimbVector;
+
+// From this many limbs on, REDC forms q and q*m with mul()
+// instead of row by row.
+const std::size_t redcThreshold = 96;
+
+// ---------------------------------------------------------
+// windowBits(bits)
+// Window width for an exponent of the given bit length.
+// ---------------------------------------------------------
+unsigned windowBits(std::size_t bits)
+{
+  static const std::size_t limits[] = {8, 24, 80, 240, 672, 1792};
+  unsigned k = 1;
+  for (std::size_t limit : limits)
+  {
+    if (bits <= limit)
+      break;
+    ++k;
+  }
+  return k;
+}
+
+// ---------------------------------------------------------
+// slidingWindow(x,e,en,sqr,mul)
+// x = x^e for a normalized exponent e[0..en), en >= 1, given
+// in-place sqr(T &y) and mul(T &y, const T &z).
+// ---------------------------------------------------------
+template <typename T, typename Sqr, typename Mul>
+void slidingWindow(T &x, const Limb *e, std::size_t en,
+                   const Sqr &sqr, const Mul &mul)
+{
+  std::size_t bits = 64*en - __builtin_clzll(e[en-1]);
+  auto bit = [e](std::size_t i) { return (e[i / 64] >> (i % 64)) & 1; };
+
+  // odd[i] = x^(2i+1).
+  unsigned k = windowBits(bits);
+  std::vector<T> odd;
+  odd.reserve(std::size_t(1) << (k - 1));
+  odd.push_back(x);
+  if (k > 1)
+  {
+    T x2 = x;
+    sqr(x2);
+    while (odd.size() < odd.capacity())
+    {
+      odd.push_back(odd.back());
+      mul(odd.back(), x2);
+    }
+  }
+
+  // Bits [j, i) form the next window: it starts at a set bit
+  // and ends at the lowest set bit within k bits.
+  std::size_t i = bits;
+  bool first = true;
+  while (i > 0)
+  {
+    if (!bit(i - 1))
+    {
+      sqr(x);
+      --i;
+      continue;
+    }
+    std::size_t j = i > k ? i - k : 0;
+    while (!bit(j))
+      ++j;
+    std::size_t v = 0;
+    for (std::size_t l = i; l-- > j;)
+      v = v << 1 | bit(l);
+
+    if (first)
+      x = odd[v >> 1];
+    else
+    {
+      for (std::size_t l = j; l < i; ++l)
+        sqr(x);
+      mul(x, odd[v >> 1]);
+    }
+    first = false;
+    i = j;
+  }
+}
+
+// ---------------------------------------------------------
+// negInverse(m0)
+// -m0^-1 mod B for odd m0. m0 is its own inverse mod 8 and
+// each Newton step x(2 - m0 x) doubles the correct bits.
+// ---------------------------------------------------------
+Limb negInverse(Limb m0)
+{
+  Limb x = m0;
+  for (int i = 0; i < 5; ++i)
+    x *= 2 - m0*x;
+  return 0 - x;
+}
+
+// ---------------------------------------------------------
+// inverse(v,m,n)
+// v[0..n) = m^-1 mod B^n for odd m, by Newton iteration: if
+// m v = 1 + B^k h mod B^2k, then v - B^k (v h) is the inverse
+// to 2k limbs.
+// ---------------------------------------------------------
+void inverse(Limb *v, const Limb *m, std::size_t n)
+{
+  v[0] = 0 - negInverse(m[0]);
+  Nat t(2*n), d(2*n);
+  for (std::size_t k = 1; k < n;)
+  {
+    std::size_t k2 = std::min(2*k, n);
+    mul(t.data(), m, k2, v, k);
+    const Limb *h = t.data() + k;
+    std::size_t hn = k2 - k;
+    if (hn <= k)
+      mul(d.data(), v, k, h, hn);
+    else
+      mul(d.data(), h, hn, v, k);
+    // v[k..k2) = -(v h) mod B^(k2-k).
+    std::fill(v + k, v + k2, 0);
+    sub_n(v + k, v + k, d.data(), hn);
+    k = k2;
+  }
+}
+
+} // namespace
+
+} // namespace limb
+
+using limb::Limb;
+
+// ---------------------------------------------------------
+// Modulus::Context
+// The constants of one modulus and the reductions built on
+// them. Residues are n-limb arrays, high zeros included.
+// ---------------------------------------------------------
+struct Modulus::Context
+{
+  Integer value;
+  std::size_t n;
+  limb::Nat m;
+  limb::Divisor divisor;
+
+  // Barrett: floor((B^2n - 1) / m), n+1 limbs.
+  limb::Nat mu;
+
+  // Montgomery, odd m only: -m^-1 mod B, -m^-1 mod B^n
+  // (from redcThreshold limbs on) and B^2n mod m.
+  bool montgomery;
+  Limb minv = 0;
+  limb::Nat mprime;
+  limb::Nat r2;
+
+  Context(const Integer &v, const Limb *a, std::size_t an);
+
+  // Limbs of scratch that reduce() needs.
+  std::size_t scratchSize() const { return 5*n + 4; }
+
+  // r[0..n) = t mod m by Barrett's method. Preconditions:
+  // t[0..2n) < B^2n.
+  void barrett(Limb *r, const Limb *t, Limb *scratch) const;
+
+  // r[0..n) = t R^-1 mod m. Clobbers t[0..2n). Preconditions:
+  // m odd, t < m R.
+  void redc(Limb *r, Limb *t, Limb *scratch) const;
+
+  // r = t R^-1 mod m in Montgomery form, t mod m otherwise.
+  void reduce(Limb *r, Limb *t, Limb *scratch) const
+  {
+    if (montgomery)
+      redc(r, t, scratch);
+    else
+      barrett(r, t, scratch);
+  }
+};
+
+Modulus::Context::Context(const Integer &v, const Limb *a, std::size_t an)
+  : value(v), n(an), m(a, a + an), divisor(a, an),
+    montgomery(a[0] & 1)
+{
+  // All-ones B^2n - 1 over m gives the n+1 limbs of mu.
+  limb::Nat top(2*n, ~Limb(0)), rem(n);
+  mu.resize(n + 1);
+  limb::divrem(mu.data(), rem.data(), top.data(), 2*n, a, n);
+
+  if (!montgomery)
+    return;
+  minv = limb::negInverse(a[0]);
+  if (n >= limb::redcThreshold)
+  {
+    mprime.resize(n);
+    limb::inverse(mprime.data(), a, n);
+    // -m^-1 = ~(m^-1) + 1 mod B^n.
+    for (Limb &x : mprime)
+      x = ~x;
+    limb::add_1(mprime.data(), mprime.data(), n, 1);
+  }
+  limb::Nat b2(2*n + 1), q(n + 2);
+  b2[2*n] = 1;
+  r2.resize(n);
+  divisor.divrem(q.data(), r2.data(), b2.data(), 2*n + 1);
+}
+
+// ---------------------------------------------------------
+// barrett(r,t,scratch)
+// q = floor(floor(t / B^(n-1)) mu / B^(n+1)) is at most three
+// below floor(t / m), so t - q m < 4m fits in n+1 limbs and a
+// few subtractions of m finish the job.
+// ---------------------------------------------------------
+void Modulus::Context::barrett(Limb *r, const Limb *t, Limb *scratch) const
+{
+  Limb *q = scratch;              // 2n+2 limbs
+  Limb *p = q + 2*n + 2;          // 2n+1 limbs
+  Limb *x = p + 2*n + 1;          // n+1 limbs
+  limb::mul(q, t + n - 1, n + 1, mu.data(), n + 1);
+  limb::mul(p, q + n + 1, n + 1, m.data(), n);
+  limb::sub_n(x, t, p, n + 1);
+  while (x[n] != 0 || limb::cmp(x, m.data(), n) >= 0)
+    x[n] -= limb::sub_n(x, x, m.data(), n);
+  std::copy(x, x + n, r);
+}
+
+// ---------------------------------------------------------
+// redc(r,t,scratch)
+// Adds q m with q = -t m^-1 mod R, clearing the low n limbs,
+// and keeps the high ones: (t + q m) / R < 2m. Row by row,
+// the carry of row i is parked in the cleared limb t[i] and
+// all of them are added in at the end.
+// ---------------------------------------------------------
+void Modulus::Context::redc(Limb *r, Limb *t, Limb *scratch) const
+{
+  Limb carry;
+  if (mprime.empty())
+  {
+    for (std::size_t i = 0; i < n; ++i)
+      t[i] = limb::addmul_1(t + i, m.data(), n, t[i] * minv);
+    carry = limb::add_n(r, t + n, t, n);
+  }
+  else
+  {
+    Limb *q = scratch;          // 2n limbs, low n used
+    Limb *p = q + 2*n;          // 2n limbs
+    limb::mul(q, t, n, mprime.data(), n);
+    limb::mul(p, q, n, m.data(), n);
+    carry = limb::add_n(p, p, t, 2*n);
+    std::copy(p + n, p + 2*n, r);
+  }
+  if (carry || limb::cmp(r, m.data(), n) >= 0)
+    limb::sub_n(r, r, m.data(), n);
+}
+
+// ---------------------------------------------------------
+// Modulus
+// ---------------------------------------------------------
+Modulus::Modulus(const Integer &m)
+{
+  if (m.sign || m.isZero())
+    throw std::domain_error("Modulus must be positive");
+  context = std::make_shared<const Context>(m, m.limbs.data(),
+                                            m.limbs.size());
+}
+
+const Integer &Modulus::value() const
+{
+  return context->value;
+}
+
+Integer Modulus::fromLimbs(const Limb *a, std::size_t n)
+{
+  Integer x;
+  x.limbs.assign(a, a + n);
+  x.normalize();
+  return x;
+}
+
+Integer Modulus::reduce(const Integer &x) const
+{
+  const Context &c = *context;
+  if (!x.sign && Integer::compareMagnitude(x, c.value) < 0)
+    return x;
+
+  std::size_t xn = x.limbs.size();
+  limb::Nat r(c.n);
+  if (xn < c.n)
+    std::copy(x.limbs.begin(), x.limbs.end(), r.begin());
+  else
+  {
+    limb::Nat q(xn - c.n + 1);
+    c.divisor.divrem(q.data(), r.data(), x.limbs.data(), xn);
+  }
+  if (x.sign && limb::normalizedSize(r.data(), c.n) != 0)
+    limb::sub_n(r.data(), c.m.data(), r.data(), c.n);
+  return fromLimbs(r.data(), c.n);
+}
+
+Integer Modulus::multiply(const Integer &a, const Integer &b) const
+{
+  const Context &c = *context;
+  Integer x = reduce(a), y = reduce(b);
+  if (x.isZero() || y.isZero())
+    return Integer();
+
+  limb::Nat t(2*c.n), s(c.scratchSize());
+  std::size_t xn = x.limbs.size(), yn = y.limbs.size();
+  if (&a == &b)
+    limb::sqr(t.data(), x.limbs.data(), xn);
+  else if (xn >= yn)
+    limb::mul(t.data(), x.limbs.data(), xn, y.limbs.data(), yn);
+  else
+    limb::mul(t.data(), y.limbs.data(), yn, x.limbs.data(), xn);
+  c.barrett(t.data(), t.data(), s.data());
+  return fromLimbs(t.data(), c.n);
+}
+
+Integer Modulus::square(const Integer &a) const
+{
+  return multiply(a, a);
+}
+
+Integer Modulus::pow(const Integer &base, const Integer &exp) const
+{
+  if (exp.sign)
+    throw std::domain_error("Modulus::pow with a negative exponent");
+  if (exp.isZero())
+    return reduce(Integer(1));
+  Integer b = reduce(base);
+  if (b.isZero())
+    return b;
+
+  const Context &c = *context;
+  std::size_t n = c.n;
+  limb::Nat x(n), t(2*n), s(c.scratchSize());
+  std::copy(b.limbs.begin(), b.limbs.end(), x.begin());
+
+  auto sqr = [&](limb::Nat &y) {
+    limb::sqr(t.data(), y.data(), n);
+    c.reduce(y.data(), t.data(), s.data());
+  };
+  auto mul = [&](limb::Nat &y, const limb::Nat &z) {
+    limb::mul(t.data(), y.data(), n, z.data(), n);
+    c.reduce(y.data(), t.data(), s.data());
+  };
+
+  // Into Montgomery form as REDC(x * B^2n), and back out as
+  // REDC(x).
+  if (c.montgomery)
+    mul(x, c.r2);
+  limb::slidingWindow(x, exp.limbs.data(), exp.limbs.size(), sqr, mul);
+  if (c.montgomery)
+  {
+    std::copy(x.begin(), x.end(), t.begin());
+    std::fill(t.begin() + n, t.end(), 0);
+    c.redc(x.data(), t.data(), s.data());
+  }
+  return fromLimbs(x.data(), n);
+}
+
+// ---------------------------------------------------------
+// pow(base,exp)
+// base = odd * 2^z, so base^exp = odd^exp * 2^(z exp): the
+// window runs on the odd part only and the zeros are shifted
+// in once.
+// ---------------------------------------------------------
+Integer Integer::pow(const Integer &base, std::uint64_t exp)
+{
+  if (exp == 0)
+    return Integer(1);
+  if (base.isZero())
+    return Integer();
+
+  std::size_t zeroLimbs = 0;
+  while (base.limbs[zeroLimbs] == 0)
+    ++zeroLimbs;
+  unsigned zeroBits = __builtin_ctzll(base.limbs[zeroLimbs]);
+  std::size_t zeros = 64*zeroLimbs + zeroBits;
+  if (zeros != 0 && exp > std::numeric_limits<std::size_t>::max() / zeros)
+    throw std::length_error("Integer::pow result too large");
+  zeros *= exp;
+
+  Integer x;
+  std::size_t xn = base.limbs.size() - zeroLimbs;
+  x.limbs.resize(xn);
+  if (zeroBits)
+    limb::rshift(x.limbs.data(), base.limbs.data() + zeroLimbs, xn,
+                 zeroBits);
+  else
+    std::copy(base.limbs.begin() + zeroLimbs, base.limbs.end(),
+              x.limbs.begin());
+  x.normalize();
+
+  if (!(x.isWord() && x.word() == 1))
+  {
+    Limb e = exp;
+    limb::slidingWindow(
+      x, &e, 1, [](Integer &y) { y = y.square(); },
+      [](Integer &y, const Integer &z) { y *= z; });
+  }
+
+  if (zeros != 0)
+    x <<= zeros;
+  x.sign = base.sign && (exp & 1);
+  return x;
+}
+
+Integer Integer::powmod(const Integer &base, const Integer &exp,
+                        const Integer &m)
+{
+  if (exp.sign)
+    throw std::domain_error("Integer::powmod with a negative exponent");
+  return Modulus(m).pow(base, exp);
+}
@@ -1,28 +1,48 @@
 // ---------------------------------------------------------
 // File: Rational.cpp
 // Implementation of arbitrary-precision rational numbers
-// using Integer (base-100 digits).
+// using Integer (base-2^64 limbs).
 //
 // Author: Abdoulie <Jallow.jku@gmail.com>
-// Last Modification: 2025-04-23
+// Last Modification: 2026-10-16
 //
 // Implements normalization, constructors, I/O, arithmetic,
-// comparison, and accessors for Rational class.
+// comparison, and accessors for Rational class. Arithmetic on
+// word-sized fractions runs in native long long with overflow
+// checks and falls back to Integer only when a result overflows.
 // ---------------------------------------------------------
 
 #include "Rational.h"
+#include "Stats.h"
+#include "ThreadPool.h"
 #include <stdexcept> // for std::runtime_error
 #include <cstdlib>   // for exit()
+#include <climits>   // for LLONG_MIN
+#include <numeric>   // for std::gcd
+#include <algorithm> // for std::max
+#include <cmath>     // for std::ldexp, std::frexp, HUGE_VAL
+
+namespace
+{
+    // Limbs in the larger part, the size the counters record.
+    [[maybe_unused]] std::size_t limbs(const Rational &r)
+    {
+        return std::max(r.numerator().limbCount(),
+                        r.denominator().limbCount());
+    }
+}
 
 // ---------------------------------------------------------
 // normalize()
-// Ensures denominator > 0 and canonical zero form.
+// Ensures denominator > 0, reduces by GCD, canonical zero form.
 // Preconditions: den != 0.
-// Postconditions: den > 0; if num == 0, den == 1.
+// Postconditions: den > 0; gcd(num,den) == 1; if num == 0,
+// den == 1.
 // Effects: may modify num and den.
 // ---------------------------------------------------------
 void Rational::normalize()
 {
+    INTEGER_STATS_SCOPE(stats::Op::RationalNormalize, limbs(*this));
     // Make denominator positive
     if (den.isNegative())
     {
@@ -34,6 +54,15 @@ void Rational::normalize()
     if (num.isZero())
     {
         den = Integer(1LL);
+        return;
+    }
+
+    // Reduce to lowest terms
+    Integer g = Integer::gcd(num, den);
+    if (g != Integer(1LL))
+    {
+        num = num / g;
+        den = den / g;
     }
 }
 
@@ -99,51 +128,218 @@ std::ostream &operator<<(std::ostream &os, const Rational &r)
 // ---------------------------------------------------------
 Rational Rational::operator-() const
 {
-    Rational result = *this;
-    result.num = -result.num;
-    result.normalize();
+    // Negation keeps the fraction in lowest terms.
+    return fromReduced(-num, den);
+}
+
+namespace
+{
+    bool isOne(const Integer &i)
+    {
+        return i == Integer(1LL);
+    }
+
+    // -----------------------------------------------------
+    // Word-sized fast path. Fractions whose parts fit in a
+    // long long (excluding LLONG_MIN, so negation is safe)
+    // are combined with overflow-checked builtins. Any
+    // overflow returns false and the caller falls back to
+    // Integer arithmetic.
+    // -----------------------------------------------------
+    bool isWord(const Integer &i)
+    {
+        return i.fitsLongLong() && i.toLongLong() != LLONG_MIN;
+    }
+}
+
+// a/b +/- c/d by Henrici's method; b, d > 0.
+bool Rational::addWords(long long a, long long b, long long c, long long d,
+                        bool subtract, long long &n, long long &m)
+{
+    if (subtract)
+        c = -c;
+    long long d1 = std::gcd(b, d);
+    long long bq = b / d1, x, y, t;
+    if (__builtin_mul_overflow(a, d / d1, &x)
+        || __builtin_mul_overflow(c, bq, &y)
+        || __builtin_add_overflow(x, y, &t)
+        || t == LLONG_MIN)
+        return false;
+    if (t == 0)
+    {
+        n = 0;
+        m = 1;
+        return true;
+    }
+    long long d2 = std::gcd(t, d1);
+    n = t / d2;
+    return !__builtin_mul_overflow(bq, d / d2, &m);
+}
+
+// (a/b)(c/d) with cross-cancellation; b, d > 0.
+bool Rational::multiplyWords(long long a, long long b, long long c,
+                             long long d, long long &n, long long &m)
+{
+    long long g1 = std::gcd(a, d), g2 = std::gcd(c, b);
+    return !__builtin_mul_overflow(a / g1, c / g2, &n)
+           && !__builtin_mul_overflow(b / g2, d / g1, &m);
+}
+
+// ---------------------------------------------------------
+// fromReduced(n, d)
+// Builds n/d, trusting the caller that it is normalized.
+// ---------------------------------------------------------
+Rational Rational::fromReduced(Integer n, Integer d)
+{
+    Rational result;
+    result.num = std::move(n);
+    result.den = std::move(d);
     return result;
 }
 
+// ---------------------------------------------------------
+// addReduced(x, y, subtract)
+// Henrici's addition (Knuth, TAOCP 4.5.1): with d1 =
+// gcd(b,d), a/b + c/d = (t/d2) / ((b/d1)(d/d2)) where
+// t = a(d/d1) + c(b/d1) and d2 = gcd(t,d1). The products
+// and the final gcd involve only the cancelled factors.
+// Integer operands and equal denominators take shortcuts.
+// ---------------------------------------------------------
+Rational Rational::addReduced(const Rational &x, const Rational &y,
+                              bool subtract)
+{
+    INTEGER_STATS_SCOPE(subtract ? stats::Op::RationalSub
+                                 : stats::Op::RationalAdd,
+                        std::max(limbs(x), limbs(y)));
+    const Integer &a = x.num, &b = x.den;
+    const Integer &c = y.num, &d = y.den;
+    auto combine = [subtract](const Integer &p, const Integer &q) {
+        return subtract ? p - q : p + q;
+    };
+    // p*q +/- r*s, accumulating the second product into the
+    // first one's buffer.
+    auto crossCombine = [subtract](const Integer &p, const Integer &q,
+                                   const Integer &r, const Integer &s) {
+        Integer t = p * q;
+        if (subtract)
+            t.subMul(r, s);
+        else
+            t.addMul(r, s);
+        return t;
+    };
+
+    if (c.isZero())
+        return x;
+    if (a.isZero())
+        return subtract ? -y : y;
+
+    long long wn, wd;
+    if (isWord(a) && isWord(b) && isWord(c) && isWord(d)
+        && addWords(a.toLongLong(), b.toLongLong(), c.toLongLong(),
+                    d.toLongLong(), subtract, wn, wd))
+        return fromReduced(Integer(wn), Integer(wd));
+
+    // a/1 +/- c/1
+    if (isOne(b) && isOne(d))
+        return fromReduced(combine(a, c), Integer(1LL));
+
+    // Common denominator: only the sum needs reducing.
+    if (b == d)
+    {
+        Integer t = combine(a, c);
+        if (t.isZero())
+            return Rational();
+        Integer g = Integer::gcd(t, b);
+        if (isOne(g))
+            return fromReduced(std::move(t), b);
+        return fromReduced(t / g, b / g);
+    }
+
+    // One integer operand: gcd(ad +/- c, d) = gcd(c, d) = 1.
+    if (isOne(b))
+        return fromReduced(combine(a * d, c), d);
+    if (isOne(d))
+        return fromReduced(combine(a, c * b), b);
+
+    Integer d1 = Integer::gcd(b, d);
+    if (isOne(d1))
+        return fromReduced(crossCombine(a, d, c, b), b * d);
+
+    Integer bq = b / d1;
+    Integer t = crossCombine(a, d / d1, c, bq);
+    if (t.isZero())
+        return Rational();
+    Integer d2 = Integer::gcd(t, d1);
+    if (isOne(d2))
+        return fromReduced(std::move(t), bq * d);
+    return fromReduced(t / d2, bq * (d / d2));
+}
+
+// ---------------------------------------------------------
+// multiplyReduced(a, b, c, d)
+// (a/b)(c/d) = ((a/g1)(c/g2)) / ((b/g2)(d/g1)) with
+// g1 = gcd(a,d), g2 = gcd(c,b); the result is already in
+// lowest terms, so no gcd of the full products is needed.
+// ---------------------------------------------------------
+Rational Rational::multiplyReduced(const Integer &a, const Integer &b,
+                                   const Integer &c, const Integer &d)
+{
+    if (a.isZero() || c.isZero())
+        return Rational();
+
+    long long wn, wd;
+    if (isWord(a) && isWord(b) && isWord(c) && isWord(d)
+        && multiplyWords(a.toLongLong(), b.toLongLong(), c.toLongLong(),
+                         d.toLongLong(), wn, wd))
+        return fromReduced(Integer(wn), Integer(wd));
+
+    Integer g1 = isOne(d) ? Integer(1LL) : Integer::gcd(a, d);
+    Integer g2 = isOne(b) ? Integer(1LL) : Integer::gcd(c, b);
+    bool cancel1 = !isOne(g1), cancel2 = !isOne(g2);
+
+    Integer n = (cancel1 ? a / g1 : a) * (cancel2 ? c / g2 : c);
+    Integer m = (cancel2 ? b / g2 : b) * (cancel1 ? d / g1 : d);
+    return fromReduced(std::move(n), std::move(m));
+}
+
 // ---------------------------------------------------------
 // operator+
-// Adds two rationals: a/b + c/d = (ad + bc)/bd.
+// Adds two rationals: a/b + c/d, see addReduced().
 // Postconditions: result normalized.
 // ---------------------------------------------------------
 Rational Rational::operator+(const Rational &r) const
 {
-    Integer new_num = (num * r.den) + (den * r.num);
-    Integer new_den = den * r.den;
-    return Rational(std::move(new_num), std::move(new_den));
+    return addReduced(*this, r, false);
 }
 
 // ---------------------------------------------------------
 // operator-
-// Subtracts two rationals: a/b - c/d = (ad - bc)/bd.
+// Subtracts two rationals: a/b - c/d, see addReduced().
 // Postconditions: result normalized.
 // ---------------------------------------------------------
 Rational Rational::operator-(const Rational &r) const
 {
-    Integer new_num = (num * r.den) - (den * r.num);
-    Integer new_den = den * r.den;
-    return Rational(std::move(new_num), std::move(new_den));
+    return addReduced(*this, r, true);
 }
 
 // ---------------------------------------------------------
 // operator*
-// Multiplies: a/b * c/d = (ac)/(bd).
+// Multiplies: a/b * c/d = (ac)/(bd), cross-cancelled.
 // Postconditions: result normalized.
 // ---------------------------------------------------------
 Rational Rational::operator*(const Rational &r) const
 {
-    Integer new_num = num * r.num;
-    Integer new_den = den * r.den;
-    return Rational(std::move(new_num), std::move(new_den));
+    INTEGER_STATS_SCOPE(stats::Op::RationalMul,
+                        std::max(limbs(*this), limbs(r)));
+    // (a/b)^2 is in lowest terms when a/b is: no gcds needed.
+    if (this == &r)
+        return fromReduced(num.square(), den.square());
+    return multiplyReduced(num, den, r.num, r.den);
 }
 
 // ---------------------------------------------------------
 // operator/
-// Divides: (a/b) / (c/d) = (ad)/(bc).
+// Divides: (a/b) / (c/d) = (ad)/(bc), cross-cancelled.
 // Preconditions: r.num != 0.
 // Postconditions: result normalized.
 // Effects: may abort on division by zero.
@@ -155,18 +351,129 @@ Rational Rational::operator/(const Rational &r) const
         std::cerr << "Error: Division by zero rational number." << std::endl;
         exit(EXIT_FAILURE);
     }
-    Integer new_num = num * r.den;
-    Integer new_den = den * r.num;
-    return Rational(std::move(new_num), std::move(new_den));
+    INTEGER_STATS_SCOPE(stats::Op::RationalDiv,
+                        std::max(limbs(*this), limbs(r)));
+    // Multiply by d/c with the sign moved to the numerator.
+    if (r.num.isNegative())
+        return multiplyReduced(num, den, -r.den, -r.num);
+    return multiplyReduced(num, den, r.den, r.num);
+}
+
+// ---------------------------------------------------------
+// Compound assignment operators +=, -=, *=, /=
+// n/1 +/- m/1 stays an integer, so the numerator is updated
+// in place; everything else reuses the binary algorithms.
+// ---------------------------------------------------------
+Rational &Rational::operator+=(const Rational &r)
+{
+    if (isOne(den) && isOne(r.den))
+        num += r.num;
+    else
+        *this = addReduced(*this, r, false);
+    return *this;
+}
+
+Rational &Rational::operator-=(const Rational &r)
+{
+    if (isOne(den) && isOne(r.den))
+        num -= r.num;
+    else
+        *this = addReduced(*this, r, true);
+    return *this;
+}
+
+Rational &Rational::operator*=(const Rational &r)
+{
+    *this = *this * r;
+    return *this;
+}
+
+Rational &Rational::operator/=(const Rational &r)
+{
+    *this = *this / r;
+    return *this;
+}
+
+// ---------------------------------------------------------
+// product(first,last), sum(first,last)
+// Balanced trees over the range (limb::reduceTree) with the
+// reducing operators at every node; leaves of a few terms
+// are folded left to right, mostly on the word fast path.
+// ---------------------------------------------------------
+namespace
+{
+    const std::size_t treeLeaf = 16;
+
+    std::size_t weight(const Rational &r)
+    {
+        return r.numerator().limbCount() + r.denominator().limbCount();
+    }
+
+    std::size_t totalWeight(const Rational *first, std::size_t n)
+    {
+        std::size_t size = 0;
+        for (std::size_t i = 0; i < n; ++i)
+            size += weight(first[i]);
+        return size;
+    }
+}
+
+Rational Rational::product(const Rational *first, const Rational *last)
+{
+    std::size_t n = static_cast<std::size_t>(last - first);
+    if (n == 0)
+        return Rational(1LL);
+    limb::ParallelScope scope(totalWeight(first, n));
+    return limb::reduceTree(
+        first, n, treeLeaf,
+        [](const Rational *p, std::size_t k) {
+            Rational r = p[0];
+            for (std::size_t i = 1; i < k; ++i)
+                r *= p[i];
+            return r;
+        },
+        [](const Rational &x, const Rational &y) { return x * y; },
+        weight);
+}
+
+Rational Rational::product(const std::vector<Rational> &values)
+{
+    return product(values.data(), values.data() + values.size());
+}
+
+Rational Rational::sum(const Rational *first, const Rational *last)
+{
+    std::size_t n = static_cast<std::size_t>(last - first);
+    if (n == 0)
+        return Rational();
+    limb::ParallelScope scope(totalWeight(first, n));
+    return limb::reduceTree(
+        first, n, treeLeaf,
+        [](const Rational *p, std::size_t k) {
+            Rational r = p[0];
+            for (std::size_t i = 1; i < k; ++i)
+                r += p[i];
+            return r;
+        },
+        [](const Rational &x, const Rational &y) { return x + y; },
+        weight);
+}
+
+Rational Rational::sum(const std::vector<Rational> &values)
+{
+    return sum(values.data(), values.data() + values.size());
 }
 
 // ---------------------------------------------------------
 // operator==
-// Compares two rationals: a/b == c/d <=> ad == bc.
+// Normalized forms are unique, so the parts match exactly
+// when the values do.
 // ---------------------------------------------------------
 bool Rational::operator==(const Rational &r) const
 {
-    return (num * r.den) == (den * r.num);
+    INTEGER_STATS_SCOPE(stats::Op::RationalCompare,
+                        std::max(limbs(*this), limbs(r)));
+    return num == r.num && den == r.den;
 }
 
 // ---------------------------------------------------------
@@ -178,6 +485,215 @@ bool Rational::operator!=(const Rational &r) const
     return !(*this == r);
 }
 
+// ---------------------------------------------------------
+// compare(r)
+// With a = |num|, b = den and A, B their bit lengths, the
+// magnitude lies in (2^(A-B-1), 2^(A-B+1)), so exponents
+// A - B two or more apart decide. Otherwise the ratios of the
+// leading 64 bits of each part, scaled by the exponent
+// difference, agree with the true ratios to about 2^-50, and
+// a relative gap above 2^-40 decides.
+// ---------------------------------------------------------
+int Rational::compare(const Rational &r) const
+{
+    INTEGER_STATS_SCOPE(stats::Op::RationalOrder,
+                        std::max(limbs(*this), limbs(r)));
+    int s = num.signum(), t = r.num.signum();
+    if (s != t)
+        return s < t ? -1 : 1;
+    if (s == 0)
+        return 0;
+
+    if (isWord(num) && isWord(den) && isWord(r.num) && isWord(r.den))
+    {
+        __int128 x = static_cast<__int128>(num.toLongLong())
+                     * r.den.toLongLong();
+        __int128 y = static_cast<__int128>(r.num.toLongLong())
+                     * den.toLongLong();
+        return x < y ? -1 : (x > y ? 1 : 0);
+    }
+
+    // Equal denominators (integers among them): compare the
+    // numerators.
+    if (den == r.den)
+        return num < r.num ? -1 : (num == r.num ? 0 : 1);
+
+    // From here on s is the sign of both; compare magnitudes.
+    long long ex = static_cast<long long>(num.bitLength())
+                   - static_cast<long long>(den.bitLength());
+    long long ey = static_cast<long long>(r.num.bitLength())
+                   - static_cast<long long>(r.den.bitLength());
+    if (ex - ey >= 2)
+        return s;
+    if (ey - ex >= 2)
+        return -s;
+
+    const double tolerance = std::ldexp(1.0, -40);
+    double qx = static_cast<double>(num.topBits())
+                / static_cast<double>(den.topBits());
+    double qy = static_cast<double>(r.num.topBits())
+                / static_cast<double>(r.den.topBits());
+    qx = std::ldexp(qx, static_cast<int>(ex - ey));
+    if (qx > qy * (1 + tolerance))
+        return s;
+    if (qx < qy * (1 - tolerance))
+        return -s;
+
+    Integer x = num * r.den, y = r.num * den;
+    return x < y ? -1 : (x == y ? 0 : 1);
+}
+
+bool Rational::operator<(const Rational &r) const
+{
+    return compare(r) < 0;
+}
+
+bool Rational::operator<=(const Rational &r) const
+{
+    return compare(r) <= 0;
+}
+
+bool Rational::operator>(const Rational &r) const
+{
+    return compare(r) > 0;
+}
+
+bool Rational::operator>=(const Rational &r) const
+{
+    return compare(r) >= 0;
+}
+
+#if __cpp_impl_three_way_comparison >= 201907L
+std::strong_ordering Rational::operator<=>(const Rational &r) const
+{
+    return compare(r) <=> 0;
+}
+#endif
+
+// ---------------------------------------------------------
+// toDouble()
+// With e = bitLength(num) - bitLength(den), |x| lies in
+// (2^(e-1), 2^(e+1)). For a normal result q = |num| 2^k / den,
+// k = 55 - e, has 55 or 56 bits; setting its low bit when the
+// division is inexact (rounding to odd) makes Integer's
+// nearest-even conversion round q as it would the exact
+// quotient, and ldexp scales exactly. Results near or below
+// 2^-1022 are instead counted in units of the smallest
+// subnormal, 2^-1074, and rounded by the remainder.
+// ---------------------------------------------------------
+double Rational::toDouble() const
+{
+    if (num.isZero())
+        return 0.0;
+    long long e = static_cast<long long>(num.bitLength())
+                  - static_cast<long long>(den.bitLength());
+    bool negative = num.isNegative();
+    double d;
+    if (e > 1025)
+        d = HUGE_VAL;
+    else if (e < -1076)
+        d = 0.0;
+    else if (e >= -1021)
+    {
+        long long k = 55 - e;
+        Integer a = num.abs(), b = den;
+        if (k >= 0)
+            a <<= static_cast<std::size_t>(k);
+        else
+            b <<= static_cast<std::size_t>(-k);
+        auto [q, r] = a.divmod(b);
+        if (!r.isZero())
+            q |= Integer(1LL);
+        d = std::ldexp(q.toDouble(), static_cast<int>(-k));
+    }
+    else
+    {
+        auto [q, r] = (num.abs() << 1074).divmod(den);
+        Integer twice = r << 1;
+        if (twice > den || (twice == den && q.testBit(0)))
+            q += Integer(1LL);
+        d = std::ldexp(q.toDouble(), -1074);
+    }
+    return negative ? -d : d;
+}
+
+// ---------------------------------------------------------
+// fromDouble(d)
+// d = m 2^(e-53) with a 53-bit integer m; odd m over a power
+// of two is already in lowest terms.
+// ---------------------------------------------------------
+Rational Rational::fromDouble(double d)
+{
+    if (!std::isfinite(d))
+    {
+        std::cerr << "Error: Rational from a non-finite double." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    if (d == 0)
+        return Rational();
+    int e;
+    double f = std::frexp(std::fabs(d), &e);
+    long long m = static_cast<long long>(std::ldexp(f, 53));
+    int zeros = __builtin_ctzll(static_cast<unsigned long long>(m));
+    m >>= zeros;
+    e += zeros - 53;
+    Integer n(d < 0 ? -m : m);
+    if (e >= 0)
+        return fromReduced(n << static_cast<std::size_t>(e), Integer(1LL));
+    return fromReduced(std::move(n),
+                       Integer(1LL) << static_cast<std::size_t>(-e));
+}
+
+// ---------------------------------------------------------
+// approximate(maxDen)
+// Runs the Euclidean algorithm on |num|/den, tracking the
+// convergents p1/q1 (and the previous p0/q0), until the next
+// denominator would exceed maxDen. The best approximations
+// within the bound are then p1/q1 and the semiconvergent
+// (p0 + j p1)/(q0 + j q1) with the largest j allowed.
+// ---------------------------------------------------------
+Rational Rational::approximate(const Integer &maxDen) const
+{
+    if (maxDen < Integer(1LL))
+    {
+        std::cerr << "Error: approximate() needs a denominator bound of at "
+                     "least 1." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    if (den <= maxDen)
+        return *this;
+
+    Integer p0(0LL), q0(1LL), p1(1LL), q1(0LL);
+    Integer n = num.abs(), d = den;
+    for (;;)
+    {
+        auto [a, r] = n.divmod(d);
+        Integer q2 = q0 + a * q1;
+        if (q2 > maxDen)
+            break;
+        Integer p2 = p0 + a * p1;
+        p0 = std::move(p1);
+        q0 = std::move(q1);
+        p1 = std::move(p2);
+        q1 = std::move(q2);
+        n = std::move(d);
+        d = std::move(r);
+    }
+
+    // Neighbouring convergents have determinant +-1, so both
+    // candidates are in lowest terms.
+    Integer j = (maxDen - q0) / q1;
+    Rational x = fromReduced(num.abs(), den);
+    Rational conv = fromReduced(std::move(p1), std::move(q1));
+    Rational semi = fromReduced(p0 + j * conv.num, q0 + j * conv.den);
+    auto distance = [&x](const Rational &y) {
+        Rational t = y - x;
+        return t.num.isNegative() ? -t : t;
+    };
+    Rational &best = distance(conv) <= distance(semi) ? conv : semi;
+    return num.isNegative() ? -best : best;
+}
+
 // ---------------------------------------------------------
 // numerator()
 // Returns numerator.
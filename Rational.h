@@ -1,9 +1,9 @@
 // ---------------------------------------------------------
 // File: Rational.h
-// Arbitrary-precision rational number class using Integer (base 100).
+// Arbitrary-precision rational number class using Integer.
 //
 // Author: Abdoulie Jallow <Jallow.jku@gmail.com>
-// Last Modification: 2025-04-23
+// Last Modification: 2026-10-16
 //
 // Defines Rational with normalization, arithmetic, comparison, and
 // I/O. Follows rule of zero; uses Integer for internal storage.
@@ -14,6 +14,10 @@
 
 #include "Integer.h"
 #include <iostream>
+#include <vector>
+#if __cpp_impl_three_way_comparison >= 201907L
+#include <compare>
+#endif
 
 // ---------------------------------------------------------
 // Class: Rational
@@ -39,6 +43,39 @@ private:
     // -------------------------------------------------------
     void normalize();
 
+    // -------------------------------------------------------
+    // addReduced(x,y,subtract)
+    // Returns x + y (or x - y) using Henrici's method: only
+    // gcd(x.den, y.den) is cancelled before multiplying.
+    // -------------------------------------------------------
+    static Rational addReduced(const Rational &x, const Rational &y,
+                               bool subtract);
+
+    // -------------------------------------------------------
+    // multiplyReduced(a,b,c,d)
+    // Returns (a/b) * (c/d) for reduced inputs by cancelling
+    // gcd(a,d) and gcd(c,b) before multiplying.
+    // Preconditions: b, d > 0; gcd(a,b) == gcd(c,d) == 1.
+    // -------------------------------------------------------
+    static Rational multiplyReduced(const Integer &a, const Integer &b,
+                                    const Integer &c, const Integer &d);
+
+    // -------------------------------------------------------
+    // addWords(a,b,c,d,subtract,n,m), multiplyWords
+    // The word-sized fast paths of addReduced and
+    // multiplyReduced: set n/m to a/b +/- c/d or (a/b)(c/d) in
+    // lowest terms, or return false if a step overflows a long
+    // long. RationalBatch runs its lanes through them.
+    // Preconditions: parts are not LLONG_MIN; b, d > 0; both
+    // fractions in lowest terms.
+    // -------------------------------------------------------
+    static bool addWords(long long a, long long b, long long c, long long d,
+                         bool subtract, long long &n, long long &m);
+    static bool multiplyWords(long long a, long long b, long long c,
+                              long long d, long long &n, long long &m);
+
+    friend class RationalBatch;
+
 public:
     // -------------------------------------------------------
     // Rational()
@@ -66,6 +103,15 @@ public:
     // -------------------------------------------------------
     explicit Rational(long long n);
 
+    // -------------------------------------------------------
+    // fromReduced(n,d)
+    // Builds n/d without normalizing, for parts known to be
+    // in lowest terms (such as ones read back by
+    // serial::deserializeRationals()).
+    // Preconditions: d > 0, gcd(n,d) == 1, d == 1 if n == 0.
+    // -------------------------------------------------------
+    static Rational fromReduced(Integer n, Integer d);
+
     // -------------------------------------------------------
     // operator<<
     // Output as "num/den" or "num" if den == 1.
@@ -84,20 +130,99 @@ public:
     // Arithmetic operators +, -, *, /
     // Input: two Rationals.
     // Preconditions: divisor != 0 for '/'.
-    // Postconditions: result normalized.
+    // Postconditions: result normalized. x * x squares the
+    // parts directly.
     // -------------------------------------------------------
     Rational operator+(const Rational &r) const;
     Rational operator-(const Rational &r) const;
     Rational operator*(const Rational &r) const;
     Rational operator/(const Rational &r) const;
 
+    // -------------------------------------------------------
+    // Compound assignment operators +=, -=, *=, /=
+    // Same results as the binary operators. Integer-valued
+    // operands update the numerator in place.
+    // Preconditions: r != 0 for '/='.
+    // -------------------------------------------------------
+    Rational &operator+=(const Rational &r);
+    Rational &operator-=(const Rational &r);
+    Rational &operator*=(const Rational &r);
+    Rational &operator/=(const Rational &r);
+
+    // -------------------------------------------------------
+    // product(first,last), sum(first,last)
+    // Product and sum of a range (or of all values), evaluated
+    // as a balanced binary tree: operands of every step stay
+    // about the same size, and large subtrees run on the
+    // thread pool. Each sum step is Henrici's addition, so
+    // the denominators are combined through gcds of similar
+    // size instead of one huge running denominator.
+    // Postconditions: result normalized; empty product 1,
+    // empty sum 0.
+    // -------------------------------------------------------
+    static Rational product(const Rational *first, const Rational *last);
+    static Rational product(const std::vector<Rational> &values);
+    static Rational sum(const Rational *first, const Rational *last);
+    static Rational sum(const std::vector<Rational> &values);
+
     // -------------------------------------------------------
     // Comparison operators ==, !=
-    // Compare two rationals in normalized form.
+    // Both sides are normalized, so equal values have equal
+    // numerators and denominators: compared field by field.
     // -------------------------------------------------------
     bool operator==(const Rational &r) const;
     bool operator!=(const Rational &r) const;
 
+    // -------------------------------------------------------
+    // compare(r)
+    // Returns -1, 0 or 1 as *this is less than, equal to or
+    // greater than r. Decides on the signs, on bit-length
+    // estimates of the magnitudes and on a 64-bit
+    // floating-point approximation of both values; only near
+    // ties pay for the exact cross products. Word-sized
+    // fractions compare in 128-bit arithmetic.
+    // -------------------------------------------------------
+    int compare(const Rational &r) const;
+
+    // -------------------------------------------------------
+    // Ordering operators <, <=, >, >= and, in C++20, <=>
+    // Built on compare().
+    // -------------------------------------------------------
+    bool operator<(const Rational &r) const;
+    bool operator<=(const Rational &r) const;
+    bool operator>(const Rational &r) const;
+    bool operator>=(const Rational &r) const;
+#if __cpp_impl_three_way_comparison >= 201907L
+    std::strong_ordering operator<=>(const Rational &r) const;
+#endif
+
+    // -------------------------------------------------------
+    // toDouble()
+    // Returns the nearest double (ties to even), subnormals
+    // and +-infinity included. One division of a 55-bit
+    // quotient; the remainder only serves as a sticky bit.
+    // -------------------------------------------------------
+    double toDouble() const;
+
+    // -------------------------------------------------------
+    // fromDouble(d)
+    // Returns the exact value of d, whose denominator is a
+    // power of two.
+    // Preconditions: d is finite.
+    // -------------------------------------------------------
+    static Rational fromDouble(double d);
+
+    // -------------------------------------------------------
+    // approximate(maxDen)
+    // Returns the closest fraction with a denominator of at
+    // most maxDen, from the continued fraction expansion: the
+    // last convergent within the bound or the best
+    // semiconvergent after it, whichever is nearer (the
+    // convergent on a tie). Returns *this if den <= maxDen.
+    // Preconditions: maxDen >= 1.
+    // -------------------------------------------------------
+    Rational approximate(const Integer &maxDen) const;
+
     // -------------------------------------------------------
     // Accessors: numerator() and denominator()
     // -------------------------------------------------------
@@ -0,0 +1,467 @@
+// ---------------------------------------------------------
+// File: RationalStore.cpp
+// Writing, mapping and reducing columnar Rational stores.
+//
+// Author: agent <agent@local>
+// Last Modification: 2026-10-16
+//
+// The file is mapped read-only with POSIX mmap. Offsets are
+// checked against the arenas on every access, so a damaged
+// file raises std::invalid_argument instead of reading past
+// the mapping.
+// ---------------------------------------------------------
+
+#include "RationalStore.h"
+#include "Limb.h"
+#include "ThreadPool.h"
+#include <algorithm>  // for std::min
+#include <cerrno>
+#include <cstring>    // for std::memcmp, std::strerror
+#include <stdexcept>  // for std::runtime_error, std::invalid_argument
+#include <utility>    // for std::pair
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+              "store files hold limbs in host order");
+
+namespace
+{
+    using Limb = Integer::Limb;
+
+    // "NUM", kind 'C', version, three zero bytes: the same
+    // shape as a serial:: bulk header.
+    const unsigned char magic[8] = {'N', 'U', 'M', 'C', 1, 0, 0, 0};
+    const std::size_t headerWords = 4;
+
+    // Values turned into Rationals at a time by one thread.
+    const std::size_t chunkValues = 4096;
+
+    [[noreturn]] void ioError(const std::string &path, const char *what)
+    {
+        throw std::runtime_error("RationalStore: cannot " + std::string(what)
+                                 + " " + path + ": "
+                                 + std::strerror(errno));
+    }
+
+    [[noreturn]] void corrupt(const char *what)
+    {
+        throw std::invalid_argument(std::string("RationalStore: ") + what);
+    }
+
+    // gcd(|n|,d) == 1, read off the mapped limbs; zero must be
+    // stored as 0/1.
+    bool lowestTerms(const IntegerView &n, const IntegerView &d)
+    {
+        if (n.isZero())
+            return d.limbCount() == 1 && d.limbs()[0] == 1;
+        std::size_t gn = std::min(n.limbCount(), d.limbCount());
+        Integer::Limb word;
+        std::vector<Integer::Limb> buffer(gn > 1 ? gn : 0);
+        Integer::Limb *g = gn > 1 ? buffer.data() : &word;
+        return limb::gcd(g, n.limbs(), n.limbCount(), d.limbs(),
+                         d.limbCount()) == 1
+               && g[0] == 1;
+    }
+
+    void put(std::FILE *f, const void *data, std::size_t bytes,
+             const std::string &path)
+    {
+        if (bytes != 0 && std::fwrite(data, 1, bytes, f) != bytes)
+            ioError(path, "write");
+    }
+
+    void putWord(std::FILE *f, std::uint64_t x, const std::string &path)
+    {
+        put(f, &x, sizeof x, path);
+    }
+
+    // Appends the whole of the temporary file from to to.
+    void copyAll(std::FILE *from, std::FILE *to, const std::string &path)
+    {
+        std::vector<unsigned char> buffer(1 << 16);
+        std::rewind(from);
+        std::size_t n;
+        while ((n = std::fread(buffer.data(), 1, buffer.size(), from)) != 0)
+            put(to, buffer.data(), n, path);
+        if (std::ferror(from))
+            ioError(path, "read back the temporary sections of");
+    }
+
+    void closeFile(std::FILE *&f)
+    {
+        if (f != nullptr)
+            std::fclose(f);
+        f = nullptr;
+    }
+}
+
+// ---------------------------------------------------------
+// Writer
+// ---------------------------------------------------------
+RationalStore::Writer::Writer(const std::string &p)
+    : path(p)
+{
+    file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr)
+        ioError(path, "create");
+    denArena = std::tmpfile();
+    numIndex = std::tmpfile();
+    denIndex = std::tmpfile();
+    if (denArena == nullptr || numIndex == nullptr || denIndex == nullptr)
+    {
+        closeFile(file);
+        closeFile(denArena);
+        closeFile(numIndex);
+        closeFile(denIndex);
+        ioError(path, "create temporary files for");
+    }
+    // The header is written last, once the sizes are known.
+    std::uint64_t zero[headerWords] = {};
+    put(file, zero, sizeof zero, path);
+}
+
+RationalStore::Writer::~Writer()
+{
+    try
+    {
+        close();
+    }
+    catch (...)
+    {
+    }
+}
+
+void RationalStore::Writer::append(const Rational &x)
+{
+    IntegerView n(x.numerator()), d(x.denominator());
+    if (!lowestTerms(n, d))
+        throw std::invalid_argument("RationalStore: value not in lowest terms");
+    putWord(numIndex, numLimbs << 1 | n.isNegative(), path);
+    putWord(denIndex, denLimbs, path);
+    put(file, n.limbs(), 8*n.limbCount(), path);
+    put(denArena, d.limbs(), 8*d.limbCount(), path);
+    numLimbs += n.limbCount();
+    denLimbs += d.limbCount();
+    ++count;
+}
+
+void RationalStore::Writer::close()
+{
+    if (file == nullptr)
+        return;
+    try
+    {
+        putWord(numIndex, numLimbs << 1, path);
+        putWord(denIndex, denLimbs, path);
+        copyAll(denArena, file, path);
+        copyAll(numIndex, file, path);
+        copyAll(denIndex, file, path);
+
+        std::uint64_t header[headerWords] = {0, count, numLimbs, denLimbs};
+        std::memcpy(header, magic, sizeof magic);
+        if (std::fseek(file, 0, SEEK_SET) != 0)
+            ioError(path, "seek in");
+        put(file, header, sizeof header, path);
+    }
+    catch (...)
+    {
+        closeFile(file);
+        closeFile(denArena);
+        closeFile(numIndex);
+        closeFile(denIndex);
+        throw;
+    }
+    closeFile(denArena);
+    closeFile(numIndex);
+    closeFile(denIndex);
+    int status = std::fclose(file);
+    file = nullptr;
+    if (status != 0)
+        ioError(path, "close");
+}
+
+void RationalStore::write(const std::string &path, const Rational *first,
+                          const Rational *last)
+{
+    Writer writer(path);
+    for (; first != last; ++first)
+        writer.append(*first);
+    writer.close();
+}
+
+void RationalStore::write(const std::string &path,
+                          const std::vector<Rational> &values)
+{
+    write(path, values.data(), values.data() + values.size());
+}
+
+// ---------------------------------------------------------
+// RationalStore(path)
+// Maps the whole file and checks that the sizes in the header
+// account for it exactly and that both indexes start at zero
+// and end at their arena sizes.
+// ---------------------------------------------------------
+RationalStore::RationalStore(const std::string &path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        ioError(path, "open");
+    struct stat info;
+    if (::fstat(fd, &info) != 0)
+    {
+        ::close(fd);
+        ioError(path, "stat");
+    }
+    mappedBytes = static_cast<std::size_t>(info.st_size);
+    if (mappedBytes < 8*headerWords)
+    {
+        ::close(fd);
+        corrupt("file too short for a header");
+    }
+    mapping = ::mmap(nullptr, mappedBytes, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        mapping = nullptr;
+        ioError(path, "map");
+    }
+
+    try
+    {
+        const std::uint64_t *words = static_cast<const std::uint64_t *>(mapping);
+        if (std::memcmp(words, magic, sizeof magic) != 0)
+            corrupt("not a store file or unsupported version");
+
+        std::size_t total = mappedBytes / 8;
+        if (mappedBytes % 8 != 0 || words[1] >= total || words[2] > total
+            || words[3] > total
+            || headerWords + words[2] + words[3] + 2*(words[1] + 1) != total)
+            corrupt("section sizes do not match the file size");
+        count = words[1];
+        numLimbs = words[2];
+        denLimbs = words[3];
+
+        numArena = words + headerWords;
+        denArena = numArena + numLimbs;
+        numIndex = denArena + denLimbs;
+        denIndex = numIndex + count + 1;
+        if (numIndex[0] >> 1 != 0 || numIndex[count] != numLimbs << 1
+            || denIndex[0] != 0 || denIndex[count] != denLimbs)
+            corrupt("index does not span the arenas");
+    }
+    catch (...)
+    {
+        ::munmap(mapping, mappedBytes);
+        throw;
+    }
+    ::madvise(mapping, mappedBytes, MADV_SEQUENTIAL);
+}
+
+RationalStore::~RationalStore()
+{
+    if (mapping != nullptr)
+        ::munmap(mapping, mappedBytes);
+}
+
+// ---------------------------------------------------------
+// Element access
+// ---------------------------------------------------------
+IntegerView RationalStore::numerator(std::size_t i) const
+{
+    std::uint64_t begin = numIndex[i] >> 1, end = numIndex[i+1] >> 1;
+    if (begin > end || end > numLimbs || (end > begin && numArena[end-1] == 0))
+        corrupt("malformed numerator");
+    return IntegerView(numIndex[i] & 1, numArena + begin, end - begin);
+}
+
+IntegerView RationalStore::denominator(std::size_t i) const
+{
+    std::uint64_t begin = denIndex[i], end = denIndex[i+1];
+    if (begin >= end || end > denLimbs || denArena[end-1] == 0)
+        corrupt("malformed denominator");
+    return IntegerView(false, denArena + begin, end - begin);
+}
+
+Rational RationalStore::operator[](std::size_t i) const
+{
+    IntegerView n = numerator(i), d = denominator(i);
+    if (n.isZero() && (d.limbCount() != 1 || d.limbs()[0] != 1))
+        corrupt("zero not stored as 0/1");
+    return Rational::fromReduced(n.toInteger(), d.toInteger());
+}
+
+void RationalStore::verify() const
+{
+    for (std::size_t i = 0; i < count; ++i)
+        if (!lowestTerms(numerator(i), denominator(i)))
+            corrupt("value not in lowest terms");
+}
+
+void RationalStore::load(std::size_t first, std::size_t last,
+                         std::vector<Rational> &out) const
+{
+    out.clear();
+    out.reserve(last - first);
+    for (std::size_t i = first; i < last; ++i)
+        out.push_back((*this)[i]);
+}
+
+std::size_t RationalStore::weight(std::size_t first, std::size_t last) const
+{
+    return (numIndex[last] >> 1) - (numIndex[first] >> 1)
+           + denIndex[last] - denIndex[first];
+}
+
+// ---------------------------------------------------------
+// reduce(first,last,leaf,combine)
+// Runs over the range in waves of one chunk per thread. Each
+// chunk is loaded and reduced by leaf(values) on its own
+// thread; the partial results then enter a stack in range
+// order, where two partials covering the same number of
+// chunks are joined by combine(x,y) at once. The stack thus
+// holds O(log n) partials of similar sizes, as in a balanced
+// tree, and only the current wave is held as Rationals.
+// Preconditions: first < last.
+// ---------------------------------------------------------
+template <typename Leaf, typename Combine>
+Rational RationalStore::reduce(std::size_t first, std::size_t last,
+                               Leaf leaf, Combine combine) const
+{
+    std::size_t size = weight(first, last);
+    limb::ParallelScope scope(size);
+    limb::ThreadPool *pool = limb::ThreadPool::current();
+    std::size_t lanes = limb::useParallel(size) ? pool->size() : 1;
+
+    std::vector<std::pair<Rational, std::size_t>> stack;
+    std::vector<Rational> wave(lanes);
+    for (std::size_t begin = first; begin < last;)
+    {
+        std::size_t chunks = std::min(
+            lanes, (last - begin + chunkValues - 1) / chunkValues);
+        limb::parallelRange(size, chunks, 1,
+                            [&](std::size_t b, std::size_t e) {
+            std::vector<Rational> values;
+            for (std::size_t k = b; k < e; ++k)
+            {
+                std::size_t from = begin + k*chunkValues;
+                load(from, std::min(from + chunkValues, last), values);
+                wave[k] = leaf(values);
+            }
+        });
+
+        for (std::size_t k = 0; k < chunks; ++k)
+        {
+            stack.emplace_back(std::move(wave[k]), 1);
+            while (stack.size() >= 2
+                   && stack[stack.size()-2].second == stack.back().second)
+            {
+                std::pair<Rational, std::size_t> top = std::move(stack.back());
+                stack.pop_back();
+                stack.back().first = combine(stack.back().first, top.first);
+                stack.back().second *= 2;
+            }
+        }
+        begin = std::min(last, begin + chunks*chunkValues);
+    }
+
+    Rational result = std::move(stack.back().first);
+    for (std::size_t i = stack.size() - 1; i-- > 0;)
+        result = combine(stack[i].first, result);
+    return result;
+}
+
+// ---------------------------------------------------------
+// sum, product, min, max
+// ---------------------------------------------------------
+namespace
+{
+    void checkRange(std::size_t first, std::size_t last, std::size_t size)
+    {
+        if (first > last || last > size)
+            throw std::out_of_range("RationalStore: range out of bounds");
+    }
+
+    void checkNonEmpty(std::size_t first, std::size_t last)
+    {
+        if (first == last)
+            throw std::domain_error("RationalStore: min or max of an "
+                                    "empty range");
+    }
+
+    // The first least (or, with greater set, greatest) value.
+    const Rational &extreme(const std::vector<Rational> &values,
+                            bool greater)
+    {
+        const Rational *best = &values[0];
+        for (const Rational &x : values)
+            if (greater ? x > *best : x < *best)
+                best = &x;
+        return *best;
+    }
+}
+
+Rational RationalStore::sum() const
+{
+    return sum(0, count);
+}
+
+Rational RationalStore::sum(std::size_t first, std::size_t last) const
+{
+    checkRange(first, last, count);
+    if (first == last)
+        return Rational();
+    return reduce(
+        first, last,
+        [](const std::vector<Rational> &v) { return Rational::sum(v); },
+        [](const Rational &x, const Rational &y) { return x + y; });
+}
+
+Rational RationalStore::product() const
+{
+    return product(0, count);
+}
+
+Rational RationalStore::product(std::size_t first, std::size_t last) const
+{
+    checkRange(first, last, count);
+    if (first == last)
+        return Rational(1LL);
+    return reduce(
+        first, last,
+        [](const std::vector<Rational> &v) { return Rational::product(v); },
+        [](const Rational &x, const Rational &y) { return x * y; });
+}
+
+Rational RationalStore::min() const
+{
+    return min(0, count);
+}
+
+Rational RationalStore::min(std::size_t first, std::size_t last) const
+{
+    checkRange(first, last, count);
+    checkNonEmpty(first, last);
+    return reduce(
+        first, last,
+        [](const std::vector<Rational> &v) { return extreme(v, false); },
+        [](const Rational &x, const Rational &y) { return y < x ? y : x; });
+}
+
+Rational RationalStore::max() const
+{
+    return max(0, count);
+}
+
+Rational RationalStore::max(std::size_t first, std::size_t last) const
+{
+    checkRange(first, last, count);
+    checkNonEmpty(first, last);
+    return reduce(
+        first, last,
+        [](const std::vector<Rational> &v) { return extreme(v, true); },
+        [](const Rational &x, const Rational &y) { return y > x ? y : x; });
+}
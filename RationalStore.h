@@ -0,0 +1,173 @@
+// ---------------------------------------------------------
+// File: RationalStore.h
+// File-backed columnar storage and streaming reductions for
+// large collections of Rationals.
+//
+// Author: agent <agent@local>
+// Last Modification: 2026-10-16
+//
+// A store file keeps the numerator limbs of all values in one
+// contiguous arena and the denominator limbs in another, plus
+// an index of limb offsets into each. All sections are 64-bit
+// words, so once the file is memory-mapped every part is read
+// in place as an IntegerView: nothing is parsed on opening and
+// only the pages a computation touches are loaded.
+//
+// Layout, in little-endian 64-bit words:
+//   header      "NUM", 'C', version, three zero bytes
+//   count n, numerator limbs N, denominator limbs D
+//   numerator arena             N limbs
+//   denominator arena           D limbs
+//   numerator index             n + 1 words, offset << 1 | sign
+//   denominator index           n + 1 words, offset
+// Value i has the numerator limbs [num[i] >> 1, num[i+1] >> 1)
+// and the denominator limbs [den[i], den[i+1]); zero has none.
+//
+// The reductions walk a range in chunks: each thread turns one
+// chunk into Rationals and reduces it, and the partial results
+// are merged pairwise as they arrive, so the memory in use is a
+// few chunks per thread regardless of the size of the store.
+// ---------------------------------------------------------
+
+#ifndef RATIONAL_STORE_H
+#define RATIONAL_STORE_H
+
+#include "IntegerView.h"
+#include "Rational.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// ---------------------------------------------------------
+// Class: RationalStore
+// Read-only view of a store file, mapped for its lifetime.
+// Throws std::runtime_error if the file cannot be opened or
+// mapped and std::invalid_argument if it is not a store file
+// or is corrupt.
+// ---------------------------------------------------------
+class RationalStore
+{
+public:
+    // -------------------------------------------------------
+    // Class: Writer
+    // Streams values into a new store file. The numerator
+    // arena goes straight to the file; the other sections go
+    // to temporary files and are appended by close(), so
+    // memory use does not grow with the number of values.
+    // -------------------------------------------------------
+    class Writer
+    {
+    public:
+        // Creates or truncates the file at path.
+        explicit Writer(const std::string &path);
+
+        // Finishes the file as close() would, ignoring errors.
+        ~Writer();
+
+        Writer(const Writer &) = delete;
+        Writer &operator=(const Writer &) = delete;
+
+        // Throws std::invalid_argument unless x is in lowest
+        // terms (only possible through Rational::fromReduced).
+        void append(const Rational &x);
+
+        // Number of values appended so far.
+        std::uint64_t size() const { return count; }
+
+        // Writes the remaining sections and the header, then
+        // closes the file. Throws std::runtime_error on an I/O
+        // error.
+        void close();
+
+    private:
+        std::string path;
+        std::FILE *file = nullptr;
+        std::FILE *denArena = nullptr;
+        std::FILE *numIndex = nullptr;
+        std::FILE *denIndex = nullptr;
+        std::uint64_t count = 0;
+        std::uint64_t numLimbs = 0;
+        std::uint64_t denLimbs = 0;
+    };
+
+    // Writes [first,last) (or all values) to a new store file.
+    static void write(const std::string &path, const Rational *first,
+                      const Rational *last);
+    static void write(const std::string &path,
+                      const std::vector<Rational> &values);
+
+    explicit RationalStore(const std::string &path);
+    ~RationalStore();
+
+    RationalStore(const RationalStore &) = delete;
+    RationalStore &operator=(const RationalStore &) = delete;
+
+    std::size_t size() const { return count; }
+
+    // -------------------------------------------------------
+    // numerator(i), denominator(i)
+    // Views of the parts of value i, pointing into the mapping;
+    // they stay valid as long as the store.
+    // Preconditions: i < size().
+    // -------------------------------------------------------
+    IntegerView numerator(std::size_t i) const;
+    IntegerView denominator(std::size_t i) const;
+
+    // Value i copied into a Rational. Only the layout is
+    // checked, as Writer stores values in lowest terms; files
+    // from elsewhere should go through verify() first.
+    Rational operator[](std::size_t i) const;
+
+    // Checks that every value is in lowest terms, one gcd per
+    // value. Throws std::invalid_argument otherwise.
+    void verify() const;
+
+    // -------------------------------------------------------
+    // sum, product, min, max over [first,last) (or all values)
+    // Streaming reductions, chunk by chunk across the thread
+    // pool when the range holds enough limbs to be worth it
+    // (Integer::multiplyThresholds().parallel). Chunks are
+    // reduced with Rational::sum and Rational::product and the
+    // partial results joined as a balanced tree.
+    // Postconditions: empty sum 0, empty product 1.
+    // Preconditions: first <= last <= size()
+    // (std::out_of_range otherwise); for min and max, also
+    // first < last (std::domain_error otherwise).
+    // -------------------------------------------------------
+    Rational sum() const;
+    Rational sum(std::size_t first, std::size_t last) const;
+    Rational product() const;
+    Rational product(std::size_t first, std::size_t last) const;
+    Rational min() const;
+    Rational min(std::size_t first, std::size_t last) const;
+    Rational max() const;
+    Rational max(std::size_t first, std::size_t last) const;
+
+private:
+    using Limb = Integer::Limb;
+
+    // Copies values [first,last) into out.
+    void load(std::size_t first, std::size_t last,
+              std::vector<Rational> &out) const;
+
+    // Limbs held by values [first,last), read off the index.
+    std::size_t weight(std::size_t first, std::size_t last) const;
+
+    template <typename Leaf, typename Combine>
+    Rational reduce(std::size_t first, std::size_t last, Leaf leaf,
+                    Combine combine) const;
+
+    void *mapping = nullptr;
+    std::size_t mappedBytes = 0;
+    std::size_t count = 0;
+    std::size_t numLimbs = 0;
+    std::size_t denLimbs = 0;
+    const Limb *numArena = nullptr;
+    const Limb *denArena = nullptr;
+    const std::uint64_t *numIndex = nullptr;
+    const std::uint64_t *denIndex = nullptr;
+};
+
+#endif // RATIONAL_STORE_H
@@ -0,0 +1,250 @@
+// ---------------------------------------------------------
+// File: Serialize.cpp
+// Writing and reading the binary record format.
+//
+// Author: agent <agent@local>
+// Last Modification: 2026-10-16
+//
+// Limbs are copied with memcpy in both directions, so writing
+// and copying reads work at any alignment; only Reader's
+// in-place views need an aligned buffer.
+// ---------------------------------------------------------
+
+#include "Serialize.h"
+#include <cstring>    // for std::memcpy, std::memcmp
+#include <stdexcept>  // for std::invalid_argument
+#include <string>
+#include <utility>    // for std::move
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+              "the serial format stores limbs in host order");
+
+namespace serial
+{
+
+namespace
+{
+
+using Limb = Integer::Limb;
+
+const unsigned char magic[3] = {'N', 'U', 'M'};
+const std::size_t headerSize = 8;
+
+// Magnitudes below this are stored in the tag.
+const Limb inlineLimit = Limb(1) << 61;
+
+void putVarint(Buffer &out, std::uint64_t x)
+{
+  while (x >= 0x80)
+  {
+    out.push_back(static_cast<unsigned char>(x | 0x80));
+    x >>= 7;
+  }
+  out.push_back(static_cast<unsigned char>(x));
+}
+
+[[noreturn]] void malformed(const char *what)
+{
+  throw std::invalid_argument(std::string("serial: ") + what);
+}
+
+void putHeader(Buffer &out, Kind kind, std::uint64_t count)
+{
+  out.insert(out.end(), magic, magic + 3);
+  out.push_back(static_cast<unsigned char>(kind));
+  out.push_back(version);
+  out.insert(out.end(), 3, 0);
+  putVarint(out, count);
+}
+
+} // namespace
+
+// ---------------------------------------------------------
+// append
+// ---------------------------------------------------------
+void append(Buffer &out, const IntegerView &x)
+{
+  std::size_t n = x.limbCount();
+  const Limb *limbs = x.limbs();
+  if (n == 0 || (n == 1 && limbs[0] < inlineLimit))
+  {
+    Limb m = n ? limbs[0] : 0;
+    putVarint(out, m << 2 | x.isNegative());
+    return;
+  }
+  putVarint(out, std::uint64_t(n) << 2 | 2 | x.isNegative());
+  out.resize((out.size() + 7) & ~std::size_t(7), 0);
+  std::size_t at = out.size();
+  out.resize(at + 8*n);
+  std::memcpy(out.data() + at, limbs, 8*n);
+}
+
+void append(Buffer &out, const Rational &x)
+{
+  append(out, x.numerator());
+  append(out, x.denominator());
+}
+
+// ---------------------------------------------------------
+// serialize
+// ---------------------------------------------------------
+void serialize(Buffer &out, const Integer *first, const Integer *last)
+{
+  putHeader(out, Kind::Integer, static_cast<std::uint64_t>(last - first));
+  for (; first != last; ++first)
+    append(out, *first);
+}
+
+void serialize(Buffer &out, const std::vector<Integer> &values)
+{
+  serialize(out, values.data(), values.data() + values.size());
+}
+
+void serialize(Buffer &out, const Rational *first, const Rational *last)
+{
+  putHeader(out, Kind::Rational, static_cast<std::uint64_t>(last - first));
+  for (; first != last; ++first)
+    append(out, *first);
+}
+
+void serialize(Buffer &out, const std::vector<Rational> &values)
+{
+  serialize(out, values.data(), values.data() + values.size());
+}
+
+// ---------------------------------------------------------
+// deserialize
+// An unaligned buffer is copied once into limb storage, which
+// keeps the offsets the padding was computed from.
+// ---------------------------------------------------------
+namespace
+{
+
+template <typename F>
+void readAll(const unsigned char *data, std::size_t size, Kind kind, F f)
+{
+  std::vector<Limb> copy;
+  if (reinterpret_cast<std::uintptr_t>(data) % alignof(Limb) != 0)
+  {
+    copy.resize((size + 7) / 8);
+    std::memcpy(copy.data(), data, size);
+    data = reinterpret_cast<const unsigned char *>(copy.data());
+  }
+  Reader reader(data, size);
+  std::uint64_t count = reader.header(kind);
+  for (std::uint64_t i = 0; i < count; ++i)
+    f(reader);
+  if (!reader.atEnd())
+    malformed("trailing bytes after the last record");
+}
+
+} // namespace
+
+std::vector<Integer> deserializeIntegers(const unsigned char *data,
+                                         std::size_t size)
+{
+  std::vector<Integer> values;
+  readAll(data, size, Kind::Integer, [&values](Reader &r) {
+    values.push_back(r.next().toInteger());
+  });
+  return values;
+}
+
+std::vector<Rational> deserializeRationals(const unsigned char *data,
+                                           std::size_t size)
+{
+  std::vector<Rational> values;
+  readAll(data, size, Kind::Rational, [&values](Reader &r) {
+    IntegerView n = r.next(), d = r.next();
+    if (d.isNegative() || d.isZero())
+      malformed("denominator not positive");
+    Integer num = n.toInteger(), den = d.toInteger();
+    // gcd(0,d) == d, so zero must be stored as 0/1.
+    if (Integer::gcd(num, den) != Integer(1))
+      malformed("rational not in lowest terms");
+    values.push_back(Rational::fromReduced(std::move(num), std::move(den)));
+  });
+  return values;
+}
+
+// ---------------------------------------------------------
+// Reader
+// ---------------------------------------------------------
+Reader::Reader(const unsigned char *d, std::size_t n)
+  : data(d), size(n)
+{
+  if (reinterpret_cast<std::uintptr_t>(d) % alignof(Limb) != 0)
+    malformed("buffer not aligned for in-place limbs");
+}
+
+std::uint64_t Reader::varint()
+{
+  std::uint64_t x = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7)
+  {
+    if (pos == size)
+      malformed("truncated varint");
+    unsigned char byte = data[pos++];
+    if (shift == 63 && byte > 1)
+      malformed("varint overflow");
+    x |= std::uint64_t(byte & 0x7F) << shift;
+    if (!(byte & 0x80))
+    {
+      if (byte == 0 && shift > 0)
+        malformed("overlong varint");
+      return x;
+    }
+  }
+  malformed("varint overflow");
+}
+
+std::uint64_t Reader::header(Kind kind)
+{
+  if (size - pos < headerSize)
+    malformed("truncated header");
+  const unsigned char *h = data + pos;
+  if (std::memcmp(h, magic, 3) != 0)
+    malformed("not a serialized buffer");
+  if (h[3] != static_cast<unsigned char>(kind))
+    malformed("buffer holds another kind of value");
+  if (h[4] != version)
+    malformed("unsupported version");
+  if (h[5] != 0 || h[6] != 0 || h[7] != 0)
+    malformed("reserved header bytes set");
+  pos += headerSize;
+  return varint();
+}
+
+IntegerView Reader::next()
+{
+  std::uint64_t tag = varint();
+  bool negative = tag & 1;
+  if (!(tag & 2))
+  {
+    Limb m = tag >> 2;
+    if (m == 0 && negative)
+      malformed("negative zero");
+    if (m >= inlineLimit)
+      malformed("inline magnitude out of range");
+    return IntegerView(negative, m);
+  }
+
+  // Only the encoding serialize() writes is accepted, so equal
+  // values always have equal bytes.
+  std::uint64_t n = tag >> 2;
+  std::size_t start = (pos + 7) & ~std::size_t(7);
+  if (start > size || n > (size - start) / 8)
+    malformed("truncated limbs");
+  for (; pos < start; ++pos)
+    if (data[pos] != 0)
+      malformed("nonzero padding");
+  const Limb *limbs = reinterpret_cast<const Limb *>(data + pos);
+  pos += 8*n;
+  if (n == 0 || limbs[n-1] == 0)
+    malformed("limbs not normalized");
+  if (n == 1 && limbs[0] < inlineLimit)
+    malformed("short magnitude not stored inline");
+  return IntegerView(negative, limbs, n);
+}
+
+} // namespace serial
@@ -0,0 +1,127 @@
+// ---------------------------------------------------------
+// File: Serialize.h
+// Compact binary format for Integer and Rational values.
+//
+// Author: agent <agent@local>
+// Last Modification: 2026-10-16
+//
+// A record encodes one Integer. It starts with a LEB128
+// varint tag = payload << 2 | limbs << 1 | sign:
+//   - limbs == 0: payload is the magnitude itself, for
+//     magnitudes below 2^61 (zero is the single byte 0);
+//   - limbs == 1: payload is the limb count n, followed by
+//     zero padding up to the next multiple of 8 bytes from the
+//     start of the buffer and then n limbs, little-endian,
+//     least significant first, the top one non-zero.
+// A Rational is the record of its numerator followed by that
+// of its denominator, in lowest terms.
+//
+// A bulk buffer written by serialize() starts with the 8-byte
+// header "NUM", kind ('I' or 'R'), version, three zero bytes,
+// followed by the varint value count and the records.
+//
+// Because limb payloads are aligned relative to the buffer
+// start, a buffer at an 8-byte aligned address, such as a
+// memory mapping, exposes every long value as a Limb array in
+// place: serial::Reader hands out IntegerViews of them
+// without copying. The format is defined for little-endian
+// hosts.
+// ---------------------------------------------------------
+
+#ifndef SERIALIZE_H
+#define SERIALIZE_H
+
+#include "Integer.h"
+#include "IntegerView.h"
+#include "Rational.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace serial
+{
+
+// Written into every bulk header; Reader::header() rejects
+// others.
+const std::uint8_t version = 1;
+
+enum class Kind : std::uint8_t
+{
+    Integer = 'I',
+    Rational = 'R'
+};
+
+using Buffer = std::vector<unsigned char>;
+
+// ---------------------------------------------------------
+// append(out,x)
+// Appends the record of x (an Integer converts to its view)
+// to out, aligning limbs relative to out's first byte.
+// ---------------------------------------------------------
+void append(Buffer &out, const IntegerView &x);
+void append(Buffer &out, const Rational &x);
+
+// ---------------------------------------------------------
+// serialize(out,first,last)
+// Appends a bulk header and the records of [first,last) (or
+// of all values) to out. out should be empty or end on a
+// multiple of 8 bytes for the buffer to be readable in place.
+// ---------------------------------------------------------
+void serialize(Buffer &out, const Integer *first, const Integer *last);
+void serialize(Buffer &out, const std::vector<Integer> &values);
+void serialize(Buffer &out, const Rational *first, const Rational *last);
+void serialize(Buffer &out, const std::vector<Rational> &values);
+
+// ---------------------------------------------------------
+// deserializeIntegers(data,size), deserializeRationals
+// Copies the values of a bulk buffer into new objects; data
+// need not be aligned. Rationals must be stored in lowest
+// terms with a positive denominator. Throws
+// std::invalid_argument on a wrong header, kind or version, or
+// on a truncated or malformed record.
+// ---------------------------------------------------------
+std::vector<Integer> deserializeIntegers(const unsigned char *data,
+                                         std::size_t size);
+std::vector<Rational> deserializeRationals(const unsigned char *data,
+                                           std::size_t size);
+
+// ---------------------------------------------------------
+// Class: Reader
+// Walks the records of a buffer without copying: next()
+// returns views into the buffer (or, for inline values, into
+// the view itself). The buffer must outlive the views.
+// ---------------------------------------------------------
+class Reader
+{
+public:
+    // Throws std::invalid_argument unless data is aligned for
+    // Integer::Limb.
+    Reader(const unsigned char *data, std::size_t size);
+
+    // Reads a bulk header and returns the value count. Throws
+    // std::invalid_argument if it is malformed, of another
+    // kind or of another version.
+    std::uint64_t header(Kind kind);
+
+    // True when every byte has been read.
+    bool atEnd() const { return pos == size; }
+
+    // Offset of the next record from the start of the buffer.
+    std::size_t offset() const { return pos; }
+
+    // Reads the next record. Throws std::invalid_argument if
+    // it is truncated, malformed or not in the canonical form
+    // serialize() writes.
+    IntegerView next();
+
+private:
+    std::uint64_t varint();
+
+    const unsigned char *data;
+    std::size_t size;
+    std::size_t pos = 0;
+};
+
+} // namespace serial
+
+#endif // SERIALIZE_H
@@ -0,0 +1,113 @@
+// ---------------------------------------------------------
+// File: Stats.cpp
+// Storage, reset and printing of the operation counters.
+//
+// Author: agent <agent@local>
+// Last Modification: 2026-10-16
+// ---------------------------------------------------------
+
+#include "Stats.h"
+#include <iostream>
+
+#ifdef INTEGER_STATS
+#if defined(__x86_64__)
+#include <x86intrin.h>  // for __rdtsc
+#else
+#include <chrono>
+#endif
+#endif
+
+namespace stats
+{
+
+const char *name(Op op)
+{
+  static const char *const names[] = {
+    "Integer +",
+    "Integer -",
+    "Integer *",
+    "Integer / %",
+    "Integer gcd",
+    "Integer normalize",
+    "Integer toString",
+    "Integer parse",
+    "Rational +",
+    "Rational -",
+    "Rational *",
+    "Rational /",
+    "Rational ==",
+    "Rational compare",
+    "Rational normalize",
+  };
+  return names[static_cast<std::size_t>(op)];
+}
+
+#ifdef INTEGER_STATS
+
+namespace detail
+{
+
+thread_local Counters counters;
+
+unsigned long long now()
+{
+#if defined(__x86_64__)
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+           std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+} // namespace detail
+
+const Counters &current()
+{
+  return detail::counters;
+}
+
+void reset()
+{
+  detail::counters = Counters();
+}
+
+#else
+
+const Counters &current()
+{
+  static const Counters none;
+  return none;
+}
+
+void reset()
+{
+}
+
+#endif // INTEGER_STATS
+
+// ---------------------------------------------------------
+// dump(os)
+// name, calls, total and mean ticks, then the non-empty size
+// buckets as "<2^i:count" (operands below 2^i limbs).
+// ---------------------------------------------------------
+void dump(std::ostream &os)
+{
+  const Counters &c = current();
+  for (std::size_t i = 0; i < static_cast<std::size_t>(Op::Count); ++i)
+  {
+    const OpCounters &o = c.ops[i];
+    if (o.calls == 0)
+      continue;
+    os << name(static_cast<Op>(i)) << ": calls " << o.calls
+       << ", ticks " << o.ticks << " (" << o.ticks / o.calls
+       << "/call), limbs";
+    for (std::size_t b = 0; b < sizeBuckets; ++b)
+      if (o.sizes[b])
+        os << " <2^" << b << ':' << o.sizes[b];
+    os << '\n';
+  }
+  os << "limb allocations: " << c.allocations << " ("
+     << c.allocatedLimbs << " limbs)\n";
+}
+
+} // namespace stats
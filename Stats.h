@@ -0,0 +1,139 @@
+// ---------------------------------------------------------
+// File: Stats.h
+// Opt-in operation counters for Integer and Rational.
+//
+// Author: agent <agent@local>
+// Last Modification: 2026-10-16
+//
+// Build every source with -DINTEGER_STATS to record, per
+// operation, the number of calls, a histogram of operand sizes
+// and the time spent, plus the heap blocks allocated for limbs.
+// Counters are thread-local, so recording takes no locks;
+// current(), dump() and reset() see the calling thread only.
+// Without INTEGER_STATS the recording macros expand to nothing
+// and the counters stay zero.
+// ---------------------------------------------------------
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <cstddef>
+#include <iosfwd>
+
+namespace stats
+{
+
+// Instrumented operations. Times are inclusive: a Rational
+// addition also shows up under the Integer operations it uses.
+enum class Op
+{
+  IntegerAdd,
+  IntegerSub,
+  IntegerMul,
+  IntegerDiv,
+  IntegerGcd,
+  IntegerNormalize,
+  IntegerToString,
+  IntegerParse,
+  RationalAdd,
+  RationalSub,
+  RationalMul,
+  RationalDiv,
+  RationalCompare,
+  RationalOrder,
+  RationalNormalize,
+  Count
+};
+
+const char *name(Op op);
+
+// Bucket i of the size histogram counts operands of
+// [2^(i-1), 2^i) limbs; bucket 0 counts zero.
+const std::size_t sizeBuckets = 65;
+
+struct OpCounters
+{
+  unsigned long long calls = 0;
+  // TSC cycles on x86-64, nanoseconds elsewhere.
+  unsigned long long ticks = 0;
+  unsigned long long sizes[sizeBuckets] = {};
+};
+
+struct Counters
+{
+  OpCounters ops[static_cast<std::size_t>(Op::Count)];
+  // Blocks the limb allocators took from the heap (pool misses
+  // and arena chunks included), and their size in limbs.
+  unsigned long long allocations = 0;
+  unsigned long long allocatedLimbs = 0;
+};
+
+// ---------------------------------------------------------
+// current(), reset(), dump(os)
+// Read, clear or print the calling thread's counters. dump
+// prints one line per operation that was called.
+// ---------------------------------------------------------
+const Counters &current();
+void reset();
+void dump(std::ostream &os);
+
+#ifdef INTEGER_STATS
+
+namespace detail
+{
+
+extern thread_local Counters counters;
+
+unsigned long long now();
+
+inline std::size_t bucket(std::size_t limbs)
+{
+  return limbs == 0 ? 0 : 64 - __builtin_clzll(limbs);
+}
+
+// Counts one call on construction and adds the elapsed time
+// on destruction.
+class Scope
+{
+public:
+  Scope(Op op, std::size_t limbs)
+    : entry(counters.ops[static_cast<std::size_t>(op)]), start(now())
+  {
+    ++entry.calls;
+    ++entry.sizes[bucket(limbs)];
+  }
+  ~Scope() { entry.ticks += now() - start; }
+
+  Scope(const Scope &) = delete;
+  Scope &operator=(const Scope &) = delete;
+
+private:
+  OpCounters &entry;
+  unsigned long long start;
+};
+
+} // namespace detail
+
+// Records the enclosing block as one call of op on an operand
+// of the given number of limbs.
+#define INTEGER_STATS_SCOPE(op, limbs) \
+  ::stats::detail::Scope integerStatsScope_((op), (limbs))
+
+// Records a heap allocation of a limb allocator.
+#define INTEGER_STATS_ALLOC(limbs)                        \
+  do                                                      \
+  {                                                       \
+    ++::stats::detail::counters.allocations;              \
+    ::stats::detail::counters.allocatedLimbs += (limbs);  \
+  } while (0)
+
+#else
+
+#define INTEGER_STATS_SCOPE(op, limbs) ((void)0)
+#define INTEGER_STATS_ALLOC(limbs) ((void)0)
+
+#endif // INTEGER_STATS
+
+} // namespace stats
+
+#endif // STATS_H
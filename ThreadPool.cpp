@@ -0,0 +1,218 @@
+// ---------------------------------------------------------
+// File: ThreadPool.cpp
+// Workers, stealing and the shared pool behind ParallelScope.
+//
+// Author: agent <agent@local>
+// Last Modification: 2026-10-16
+// ---------------------------------------------------------
+
+#include "ThreadPool.h"
+
+namespace limb
+{
+
+namespace
+{
+
+// Pool and queue of the calling thread. Workers own queue
+// index; other threads use the shared queue at the end.
+thread_local ThreadPool *currentPool = nullptr;
+thread_local std::size_t currentQueue = 0;
+
+unsigned configuredThreads()
+{
+  std::size_t t = Integer::multiplyThresholds().threads;
+  if (t == 0)
+    t = std::thread::hardware_concurrency();
+  return t == 0 ? 1 : static_cast<unsigned>(t);
+}
+
+} // namespace
+
+// ---------------------------------------------------------
+// ThreadPool
+// ---------------------------------------------------------
+ThreadPool::ThreadPool(unsigned n)
+  : threads(n == 0 ? 1 : n)
+{
+  for (unsigned i = 0; i < threads; ++i)
+    queues.push_back(std::make_unique<Queue>());
+  for (unsigned i = 0; i + 1 < threads; ++i)
+    workers.emplace_back([this, i] { workerLoop(i); });
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (auto &w : workers)
+    w.join();
+}
+
+ThreadPool *ThreadPool::current()
+{
+  return currentPool;
+}
+
+void ThreadPool::push(Task task)
+{
+  std::size_t q = currentPool == this ? currentQueue : queues.size() - 1;
+  {
+    std::lock_guard<std::mutex> lock(queues[q]->mutex);
+    queues[q]->tasks.push_back(std::move(task));
+  }
+  queued.fetch_add(1);
+  {
+    // Pairs with the predicate check in workerLoop().
+    std::lock_guard<std::mutex> lock(sleepMutex);
+  }
+  wake.notify_one();
+}
+
+// ---------------------------------------------------------
+// runOne()
+// Runs the newest task of the caller's own queue or, failing
+// that, steals the oldest task of another queue. Returns
+// false if every queue was empty.
+// ---------------------------------------------------------
+bool ThreadPool::runOne()
+{
+  std::size_t own = currentPool == this ? currentQueue : queues.size() - 1;
+  std::size_t n = queues.size();
+  Task task;
+  bool found = false;
+  for (std::size_t k = 0; k < n && !found; ++k)
+  {
+    Queue &q = *queues[(own + k) % n];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.tasks.empty())
+      continue;
+    if (k == 0)
+    {
+      task = std::move(q.tasks.back());
+      q.tasks.pop_back();
+    }
+    else
+    {
+      task = std::move(q.tasks.front());
+      q.tasks.pop_front();
+    }
+    found = true;
+  }
+  if (!found)
+    return false;
+
+  queued.fetch_sub(1);
+  std::exception_ptr error;
+  try
+  {
+    task.fn();
+  }
+  catch (...)
+  {
+    error = std::current_exception();
+  }
+  task.group->finish(error);
+  return true;
+}
+
+void ThreadPool::workerLoop(unsigned index)
+{
+  currentPool = this;
+  currentQueue = index;
+  for (;;)
+  {
+    if (runOne())
+      continue;
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    wake.wait(lock, [this] { return stopping || queued.load() > 0; });
+    if (stopping && queued.load() == 0)
+      return;
+  }
+}
+
+// ---------------------------------------------------------
+// TaskGroup
+// ---------------------------------------------------------
+TaskGroup::~TaskGroup()
+{
+  // Reached early only when the caller's own share threw;
+  // the queued tasks still reference its frame.
+  while (pending.load(std::memory_order_acquire) > 0)
+    if (!pool.runOne())
+      std::this_thread::yield();
+}
+
+void TaskGroup::run(std::function<void()> fn)
+{
+  pending.fetch_add(1, std::memory_order_relaxed);
+  pool.push(ThreadPool::Task{std::move(fn), this});
+}
+
+void TaskGroup::wait()
+{
+  while (pending.load(std::memory_order_acquire) > 0)
+    if (!pool.runOne())
+      std::this_thread::yield();
+  if (error)
+  {
+    std::exception_ptr e = error;
+    error = nullptr;
+    std::rethrow_exception(e);
+  }
+}
+
+void TaskGroup::finish(std::exception_ptr e)
+{
+  if (e)
+  {
+    std::lock_guard<std::mutex> lock(errorMutex);
+    if (!error)
+      error = e;
+  }
+  pending.fetch_sub(1, std::memory_order_release);
+}
+
+// ---------------------------------------------------------
+// ParallelScope
+// The shared pool is replaced when the configured thread
+// count changes; callers still running on the old pool keep
+// it alive through their shared_ptr.
+// ---------------------------------------------------------
+ParallelScope::ParallelScope(std::size_t size)
+{
+  if (currentPool != nullptr
+      || size < Integer::multiplyThresholds().parallel)
+    return;
+  unsigned want = configuredThreads();
+  if (want <= 1)
+    return;
+
+  static std::mutex mutex;
+  static std::shared_ptr<ThreadPool> shared;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!shared || shared->size() != want)
+      shared = std::make_shared<ThreadPool>(want);
+    held = shared;
+  }
+  currentPool = held.get();
+  currentQueue = held->queues.size() - 1;
+}
+
+ParallelScope::~ParallelScope()
+{
+  if (held)
+    currentPool = nullptr;
+}
+
+bool useParallel(std::size_t size)
+{
+  return currentPool != nullptr
+         && size >= Integer::multiplyThresholds().parallel;
+}
+
+} // namespace limb
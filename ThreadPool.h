@@ -0,0 +1,226 @@
+// ---------------------------------------------------------
+// File: ThreadPool.h
+// Work-stealing thread pool for the large multiplications.
+//
+// Author: agent <agent@local>
+// Last Modification: 2026-10-16
+//
+// Internal to the Integer implementation. Each worker owns a
+// deque: it pushes and pops its own tasks at the back and,
+// when idle, steals from the front of the others. A thread
+// waiting for a TaskGroup keeps running queued tasks, so
+// nested fork/join (an NTT inside a Toom-3 branch) cannot
+// deadlock. One process-wide pool, sized from
+// Integer::multiplyThresholds().threads, is shared by all
+// callers; it is created on the first product large enough
+// to use it.
+// ---------------------------------------------------------
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include "Integer.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace limb
+{
+
+class TaskGroup;
+
+class ThreadPool
+{
+public:
+  // Runs tasks on threads - 1 workers plus the waiting caller.
+  explicit ThreadPool(unsigned threads);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  unsigned size() const { return threads; }
+
+  // Pool serving the calling thread: a worker's own pool or
+  // the one entered through a ParallelScope; nullptr if none.
+  static ThreadPool *current();
+
+private:
+  friend class TaskGroup;
+  friend class ParallelScope;
+
+  struct Task
+  {
+    std::function<void()> fn;
+    TaskGroup *group;
+  };
+
+  struct Queue
+  {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  void push(Task task);
+  bool runOne();
+  void workerLoop(unsigned index);
+
+  unsigned threads;
+  // One deque per worker, plus one for tasks pushed by
+  // threads outside the pool.
+  std::vector<std::unique_ptr<Queue>> queues;
+  std::vector<std::thread> workers;
+
+  std::atomic<std::size_t> queued{0};
+  std::mutex sleepMutex;
+  std::condition_variable wake;
+  bool stopping = false;
+};
+
+// ---------------------------------------------------------
+// TaskGroup
+// Fork/join over a pool: run() queues a task, wait() blocks
+// until all have finished, helping with queued work, and
+// rethrows the first exception a task threw.
+// ---------------------------------------------------------
+class TaskGroup
+{
+public:
+  explicit TaskGroup(ThreadPool &p) : pool(p) {}
+  ~TaskGroup();
+
+  void run(std::function<void()> fn);
+  void wait();
+
+private:
+  friend class ThreadPool;
+
+  void finish(std::exception_ptr e);
+
+  ThreadPool &pool;
+  std::atomic<std::size_t> pending{0};
+  std::mutex errorMutex;
+  std::exception_ptr error;
+};
+
+// ---------------------------------------------------------
+// ParallelScope
+// Makes the shared pool current for the calling thread while
+// it lives, if the product is at least
+// Integer::multiplyThresholds().parallel limbs, more than one
+// thread is configured and no pool is current yet.
+// ---------------------------------------------------------
+class ParallelScope
+{
+public:
+  explicit ParallelScope(std::size_t size);
+  ~ParallelScope();
+
+  ParallelScope(const ParallelScope &) = delete;
+  ParallelScope &operator=(const ParallelScope &) = delete;
+
+private:
+  std::shared_ptr<ThreadPool> held;
+};
+
+// True if work of the given size (limbs of the shorter
+// operand) should be split across the current pool.
+bool useParallel(std::size_t size);
+
+// ---------------------------------------------------------
+// parallelInvoke(size,f...)
+// Calls every f, concurrently when useParallel(size).
+// ---------------------------------------------------------
+template <typename Last>
+void parallelInvokeIn(TaskGroup &, Last &&last)
+{
+  last();
+}
+
+template <typename First, typename... Rest>
+void parallelInvokeIn(TaskGroup &group, First &&first, Rest &&...rest)
+{
+  group.run(std::forward<First>(first));
+  parallelInvokeIn(group, std::forward<Rest>(rest)...);
+}
+
+template <typename... F>
+void parallelInvoke(std::size_t size, F &&...f)
+{
+  if (!useParallel(size))
+  {
+    (f(), ...);
+    return;
+  }
+  TaskGroup group(*ThreadPool::current());
+  parallelInvokeIn(group, std::forward<F>(f)...);
+  group.wait();
+}
+
+// ---------------------------------------------------------
+// parallelRange(size,n,grain,body)
+// Calls body(begin,end) over [0,n) in chunks of about grain,
+// concurrently when useParallel(size).
+// ---------------------------------------------------------
+template <typename Body>
+void parallelRange(std::size_t size, std::size_t n, std::size_t grain,
+                   Body body)
+{
+  if (n <= grain || !useParallel(size))
+  {
+    body(std::size_t(0), n);
+    return;
+  }
+  TaskGroup group(*ThreadPool::current());
+  for (std::size_t begin = grain; begin < n; begin += grain)
+  {
+    std::size_t end = begin + grain < n ? begin + grain : n;
+    group.run([&body, begin, end] { body(begin, end); });
+  }
+  body(std::size_t(0), grain);
+  group.wait();
+}
+
+// ---------------------------------------------------------
+// reduceTree(first,n,leafSize,leaf,combine,weight)
+// Folds the n >= 1 values at first as a balanced binary
+// tree: runs of at most leafSize values go to leaf(first,n),
+// and the results for the two halves of a longer run are
+// joined by combine(x,y), so both operands stay about the
+// same size. The halves run concurrently when useParallel()
+// of their total weight(value), in limbs.
+// ---------------------------------------------------------
+template <typename T, typename Leaf, typename Combine, typename Weight>
+auto reduceTree(const T *first, std::size_t n, std::size_t leafSize,
+                const Leaf &leaf, const Combine &combine,
+                const Weight &weight) -> decltype(leaf(first, n))
+{
+  if (n <= leafSize)
+    return leaf(first, n);
+
+  // Only summed when there is a pool to hand work to.
+  std::size_t size = 0;
+  if (ThreadPool::current() != nullptr)
+    for (std::size_t i = 0; i < n; ++i)
+      size += weight(first[i]);
+
+  std::size_t half = n / 2;
+  decltype(leaf(first, n)) x, y;
+  parallelInvoke(
+    size,
+    [&] { x = reduceTree(first, half, leafSize, leaf, combine, weight); },
+    [&] { y = reduceTree(first + half, n - half, leafSize, leaf, combine,
+                         weight); });
+  return combine(std::move(x), std::move(y));
+}
+
+} // namespace limb
+
+#endif // THREAD_POOL_H
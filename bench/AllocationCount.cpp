@@ -0,0 +1,121 @@
+// ---------------------------------------------------------
+// File: bench/AllocationCount.cpp
+// Counts heap allocations made by common Integer and Rational
+// operations on word-sized and multi-word values.
+//
+// Author: agent <agent@local>
+// Last Modification: 2026-10-16
+//
+// Build from the repository root together with every library
+// source except main.cpp, e.g.:
+//   g++ -std=c++17 -O2 -I. bench/AllocationCount.cpp
+//       $(ls *.cpp | grep -v main.cpp) -pthread -o alloc_count
+// ---------------------------------------------------------
+
+#include "Integer.h"
+#include "Rational.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// Global operator new is replaced to count every allocation.
+// Pool workers allocate too, so the counter is atomic.
+static std::atomic<unsigned long long> allocations{0};
+
+void *operator new(std::size_t n)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(n ? n : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t n) { return operator new(n); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+
+// ---------------------------------------------------------
+// report(name,iterations,body)
+// Runs body iterations times and prints allocations per call.
+// ---------------------------------------------------------
+template <typename Body>
+static void report(const char *name, int iterations, Body body)
+{
+    unsigned long long before = allocations;
+    for (int i = 0; i < iterations; ++i)
+        body(i);
+    double perCall = double(allocations - before) / iterations;
+    std::printf("%-32s %10.2f allocs/op\n", name, perCall);
+}
+
+// Keeps results alive so the work is not optimized away.
+static volatile int sink = 0;
+
+static void keep(int x)
+{
+    sink = sink + x;
+}
+
+int main()
+{
+    const int n = 100000;
+    Integer small(123456789LL), other(-987654321LL);
+    Integer wide = Integer(1LL << 62) * Integer(1LL << 62);
+    Integer big = wide * wide * wide;
+
+    report("Integer(long long)", n, [](int i) {
+        Integer x(i);
+        keep(x.isZero());
+    });
+    report("Integer copy (1 limb)", n, [&](int) {
+        Integer x = small;
+        keep(x.isZero());
+    });
+    report("Integer + (1 limb)", n, [&](int) {
+        keep((small + other).isZero());
+    });
+    report("Integer * (1 limb)", n, [&](int) {
+        keep((small * other).isZero());
+    });
+    report("Integer / (2 limbs)", n, [&](int) {
+        keep((wide / small).isZero());
+    });
+    report("Integer::gcd (2 limbs)", n, [&](int) {
+        keep(Integer::gcd(wide, other).isZero());
+    });
+    report("Integer copy (7 limbs)", n, [&](int) {
+        Integer x = big;
+        keep(x.isZero());
+    });
+    report("Integer * (7 limbs)", n, [&](int) {
+        keep((big * big).isZero());
+    });
+    Integer sum;
+    report("Integer += (7 limbs, running)", n, [&](int) {
+        sum += big;
+    });
+    keep(sum.isZero());
+    report("Integer a + b + c (7 limbs)", n, [&](int) {
+        keep((big + big + big).isZero());
+    });
+
+    Rational a(Integer(355LL), Integer(113LL));
+    Rational b(Integer(-22LL), Integer(7LL));
+    report("Rational(long long)", n, [](int i) {
+        Rational x(static_cast<long long>(i));
+        keep(x.numerator().isZero());
+    });
+    report("Rational +", n, [&](int) {
+        keep((a + b).numerator().isZero());
+    });
+    report("Rational *", n, [&](int) {
+        keep((a * b).numerator().isZero());
+    });
+    report("Rational /", n, [&](int) {
+        keep((a / b).numerator().isZero());
+    });
+    return 0;
+}
@@ -0,0 +1,637 @@
+// ---------------------------------------------------------
+// File: bench/Benchmark.cpp
+// Performance suite for Integer and Rational: size sweeps of
+// every operator plus a few realistic workloads, reported as
+// ns/op and allocations/op.
+//
+// Author: agent <agent@local>
+// Last Modification: 2026-10-16
+//
+// Build from the repository root together with every library
+// source except main.cpp, e.g.:
+//   g++ -std=c++17 -O2 -I. bench/Benchmark.cpp
+//       $(ls *.cpp | grep -v main.cpp) -pthread -o benchmark
+//
+// Options (modelled on Google Benchmark):
+//   --format=console|json|csv   output format (console)
+//   --filter=TEXT               run names containing TEXT
+//   --max-digits=N              largest operand size (10^7)
+//   --min-time=S                seconds per benchmark (0.1)
+//   --karatsuba=N --toom3=N --ntt=N --divide-dc=N
+//   --square-karatsuba=N --square-toom3=N --square-ntt=N
+//   --newton=N --half-gcd=N     override the thresholds
+//   --parallel=N --threads=N    parallel multiplication settings
+//
+// Each benchmark is repeated until it has run for at least
+// --min-time seconds. Operands are built from random digit
+// strings before timing starts. The full sweep to 10^7 digits
+// takes several minutes, mostly in the largest Rational
+// operands; --max-digits=100000 gives a quick run.
+// ---------------------------------------------------------
+
+#include "Integer.h"
+#include "IntegerBatch.h"
+#include "IntegerExpr.h"
+#include "Modulus.h"
+#include "Rational.h"
+#include "RationalStore.h"
+#include "Serialize.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Global operator new is replaced to count every allocation.
+// Pool workers allocate too, so the counter is atomic.
+static std::atomic<unsigned long long> allocations{0};
+
+void *operator new(std::size_t n)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(n ? n : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t n) { return operator new(n); }
+// GCC pairs the free() below with the out-of-line operator
+// new above and reports a mismatch that is not there.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+#pragma GCC diagnostic pop
+
+// Keeps results alive so the work is not optimized away.
+static volatile int sink = 0;
+
+static void keep(int x)
+{
+    sink = sink + x;
+}
+
+// ---------------------------------------------------------
+// Command line options
+// ---------------------------------------------------------
+struct Options
+{
+    std::string format = "console";
+    std::string filter;
+    std::size_t maxDigits = 10000000;
+    double minTime = 0.1;
+};
+
+// ---------------------------------------------------------
+// Result
+// One line of output.
+// ---------------------------------------------------------
+struct Result
+{
+    std::string name;
+    std::size_t size;        // digits, or the workload parameter
+    unsigned long long iterations;
+    double nsPerOp;
+    double allocsPerOp;
+};
+
+// ---------------------------------------------------------
+// run(name,size,options,body)
+// Times body(), doubling the iteration count (at most tenfold
+// per step) until the batch takes --min-time.
+// ---------------------------------------------------------
+static Result run(const std::string &name, std::size_t size,
+                  const Options &options,
+                  const std::function<void()> &body)
+{
+    using Clock = std::chrono::steady_clock;
+    unsigned long long iterations = 1;
+    for (;;)
+    {
+        unsigned long long before = allocations;
+        Clock::time_point start = Clock::now();
+        for (unsigned long long i = 0; i < iterations; ++i)
+            body();
+        double seconds
+            = std::chrono::duration<double>(Clock::now() - start).count();
+        unsigned long long allocs = allocations - before;
+
+        if (seconds >= options.minTime || iterations >= (1ULL << 40))
+            return Result{name, size, iterations,
+                          seconds * 1e9 / iterations,
+                          double(allocs) / iterations};
+
+        // Aim 40% past the target so the next batch usually ends it.
+        double scale = seconds > 0 ? 1.4 * options.minTime / seconds : 10;
+        scale = scale < 2 ? 2 : (scale > 10 ? 10 : scale);
+        iterations = static_cast<unsigned long long>(iterations * scale);
+    }
+}
+
+// ---------------------------------------------------------
+// Output
+// ---------------------------------------------------------
+static void printHeader(const Options &options)
+{
+    const Integer::MultiplyThresholds &m = Integer::multiplyThresholds();
+    const Integer::DivideThresholds &d = Integer::divideThresholds();
+    const Integer::GcdThresholds &g = Integer::gcdThresholds();
+    if (options.format == "json")
+    {
+        std::printf("{\n  \"context\": {\n");
+        std::printf("    \"karatsuba\": %zu, \"toom3\": %zu, \"ntt\": %zu,\n",
+                    m.karatsuba, m.toom3, m.ntt);
+        std::printf("    \"square_karatsuba\": %zu, \"square_toom3\": %zu,"
+                    " \"square_ntt\": %zu,\n",
+                    m.squareKaratsuba, m.squareToom3, m.squareNtt);
+        std::printf("    \"divide_dc\": %zu, \"newton\": %zu,"
+                    " \"half_gcd\": %zu,\n",
+                    d.divideAndConquer, d.newton, g.halfGcd);
+        std::printf("    \"parallel\": %zu, \"threads\": %zu,\n",
+                    m.parallel, m.threads);
+        std::printf("    \"min_time\": %g\n  },\n  \"benchmarks\": [",
+                    options.minTime);
+    }
+    else if (options.format == "csv")
+    {
+        std::printf("name,size,iterations,ns_per_op,allocs_per_op\n");
+    }
+    else
+    {
+        std::printf("thresholds: karatsuba=%zu toom3=%zu ntt=%zu "
+                    "square_karatsuba=%zu square_toom3=%zu square_ntt=%zu "
+                    "divide_dc=%zu newton=%zu half_gcd=%zu "
+                    "parallel=%zu threads=%zu\n",
+                    m.karatsuba, m.toom3, m.ntt,
+                    m.squareKaratsuba, m.squareToom3, m.squareNtt,
+                    d.divideAndConquer, d.newton, g.halfGcd,
+                    m.parallel, m.threads);
+        std::printf("%-36s %14s %12s %12s\n",
+                    "Benchmark", "ns/op", "iterations", "allocs/op");
+    }
+}
+
+static void printResult(const Result &r, const Options &options, bool first)
+{
+    std::string full = r.name + "/" + std::to_string(r.size);
+    if (options.format == "json")
+        std::printf("%s\n    {\"name\": \"%s\", \"size\": %zu, "
+                    "\"iterations\": %llu, \"ns_per_op\": %.1f, "
+                    "\"allocs_per_op\": %.2f}",
+                    first ? "" : ",", full.c_str(), r.size,
+                    r.iterations, r.nsPerOp, r.allocsPerOp);
+    else if (options.format == "csv")
+        std::printf("%s,%zu,%llu,%.1f,%.2f\n", r.name.c_str(), r.size,
+                    r.iterations, r.nsPerOp, r.allocsPerOp);
+    else
+        std::printf("%-36s %14.1f %12llu %12.2f\n", full.c_str(),
+                    r.nsPerOp, r.iterations, r.allocsPerOp);
+    std::fflush(stdout);
+}
+
+static void printFooter(const Options &options)
+{
+    if (options.format == "json")
+        std::printf("\n  ]\n}\n");
+}
+
+// ---------------------------------------------------------
+// Operands
+// ---------------------------------------------------------
+
+// A random integer of exactly the given number of decimal digits.
+static Integer randomInteger(std::size_t digits, std::mt19937_64 &rng)
+{
+    std::string s(digits, '0');
+    s[0] = static_cast<char>('1' + rng() % 9);
+    for (std::size_t i = 1; i < digits; ++i)
+        s[i] = static_cast<char>('0' + rng() % 10);
+    return Integer(s);
+}
+
+// Operand sizes 1, 3, 10, 30, ... up to maxDigits.
+static std::vector<std::size_t> sizes(std::size_t maxDigits)
+{
+    std::vector<std::size_t> v;
+    for (std::size_t d = 1; d <= maxDigits; d *= 10)
+    {
+        v.push_back(d);
+        if (3 * d <= maxDigits)
+            v.push_back(3 * d);
+    }
+    return v;
+}
+
+// ---------------------------------------------------------
+// Suite
+// Registers every benchmark; each entry builds its operands
+// lazily so filtered-out sizes cost nothing.
+// ---------------------------------------------------------
+struct Suite
+{
+    const Options &options;
+    bool first = true;
+
+    bool selected(const std::string &name) const
+    {
+        return name.find(options.filter) != std::string::npos;
+    }
+
+    void add(const std::string &name, std::size_t size,
+             const std::function<void()> &body)
+    {
+        printResult(run(name, size, options, body), options, first);
+        first = false;
+    }
+
+    void integerSweep()
+    {
+        static const char *ops[] = {"Integer/add", "Integer/sub",
+                                    "Integer/mul", "Integer/square",
+                                    "Integer/mul_add",
+                                    "Integer/div", "Integer/shift",
+                                    "Integer/and",
+                                    "Integer/compare", "Integer/to_string",
+                                    "Integer/parse"};
+        std::mt19937_64 rng(1);
+        for (const char *op : ops)
+        {
+            if (!selected(op))
+                continue;
+            for (std::size_t d : sizes(options.maxDigits))
+            {
+                Integer a = randomInteger(d, rng);
+                Integer b = randomInteger(d, rng);
+                std::string name = op;
+                if (name == "Integer/add")
+                    add(name, d, [&] { keep((a + b).isZero()); });
+                else if (name == "Integer/sub")
+                    add(name, d, [&] { keep((a - b).isZero()); });
+                else if (name == "Integer/mul")
+                    add(name, d, [&] { keep((a * b).isZero()); });
+                else if (name == "Integer/square")
+                    add(name, d, [&] { keep(a.square().isZero()); });
+                else if (name == "Integer/mul_add")
+                {
+                    // a*b + b*a fused into one reused buffer.
+                    Integer t;
+                    add(name, d, [&] {
+                        expr::assign(t, expr::lazy(a) * b + expr::lazy(b) * a);
+                        keep(t.isZero());
+                    });
+                }
+                else if (name == "Integer/div")
+                {
+                    // 2d-digit dividend by a d-digit divisor.
+                    Integer n = a * b + a;
+                    add(name, d, [&] { keep((n / b).isZero()); });
+                }
+                else if (name == "Integer/shift")
+                    add(name, d, [&] { keep((a << 67).isZero()); });
+                else if (name == "Integer/and")
+                {
+                    // Two's complement of the negative operand on the fly.
+                    Integer c = -b;
+                    add(name, d, [&] { keep((a & c).isZero()); });
+                }
+                else if (name == "Integer/compare")
+                {
+                    // Equal values: every limb is inspected.
+                    Integer c = a;
+                    add(name, d, [&] { keep(a < c); });
+                }
+                else if (name == "Integer/to_string")
+                    add(name, d, [&] { keep(int(a.toString().size())); });
+                else
+                {
+                    std::string s = a.toString();
+                    add(name, d, [&] { keep(Integer(s).isZero()); });
+                }
+            }
+        }
+    }
+
+    void rationalSweep()
+    {
+        static const char *ops[] = {"Rational/add", "Rational/sub",
+                                    "Rational/mul", "Rational/div",
+                                    "Rational/negate", "Rational/equal",
+                                    "Rational/less", "Rational/to_double",
+                                    "Rational/output"};
+        std::mt19937_64 rng(2);
+        for (const char *op : ops)
+        {
+            if (!selected(op))
+                continue;
+            for (std::size_t d : sizes(options.maxDigits))
+            {
+                Rational x(randomInteger(d, rng), randomInteger(d, rng));
+                Rational y(randomInteger(d, rng), randomInteger(d, rng));
+                std::string name = op;
+                if (name == "Rational/add")
+                    add(name, d, [&] {
+                        keep((x + y).numerator().isZero()); });
+                else if (name == "Rational/sub")
+                    add(name, d, [&] {
+                        keep((x - y).numerator().isZero()); });
+                else if (name == "Rational/mul")
+                    add(name, d, [&] {
+                        keep((x * y).numerator().isZero()); });
+                else if (name == "Rational/div")
+                    add(name, d, [&] {
+                        keep((x / y).numerator().isZero()); });
+                else if (name == "Rational/negate")
+                    add(name, d, [&] {
+                        keep((-x).numerator().isZero()); });
+                else if (name == "Rational/equal")
+                {
+                    Rational z = x;
+                    add(name, d, [&] { keep(x == z); });
+                }
+                else if (name == "Rational/less")
+                {
+                    // A near tie: only the exact cross products decide.
+                    Rational z = x + Rational(Integer(1LL), x.denominator()
+                                              * x.denominator());
+                    add(name, d, [&] { keep(x < z); });
+                }
+                else if (name == "Rational/to_double")
+                    add(name, d, [&] { keep(x.toDouble() > 0); });
+                else
+                    add(name, d, [&] {
+                        std::ostringstream os;
+                        os << x;
+                        keep(int(os.tellp()));
+                    });
+            }
+        }
+    }
+
+    void workloads()
+    {
+        // Partial sums of the harmonic series, 1 + 1/2 + ... + 1/n.
+        if (selected("Workload/harmonic"))
+            for (std::size_t n : {100, 1000, 5000})
+                add("Workload/harmonic", n, [n] {
+                    Rational h;
+                    for (std::size_t k = 1; k <= n; ++k)
+                        h += Rational(Integer(1LL),
+                                      Integer(static_cast<long long>(k)));
+                    keep(h.numerator().isZero());
+                });
+
+        // The same sum as one balanced tree, terms built outside.
+        if (selected("Workload/harmonic_tree"))
+            for (std::size_t n : {100, 1000, 5000, 100000})
+            {
+                std::vector<Rational> terms;
+                for (std::size_t k = 1; k <= n; ++k)
+                    terms.emplace_back(Integer(1LL),
+                                       Integer(static_cast<long long>(k)));
+                add("Workload/harmonic_tree", n, [terms] {
+                    keep(Rational::sum(terms).numerator().isZero());
+                });
+            }
+
+        // n! as a running product of word-sized factors.
+        if (selected("Workload/factorial"))
+            for (std::size_t n : {100, 1000, 10000})
+                add("Workload/factorial", n, [n] {
+                    Integer f(1LL);
+                    for (std::size_t k = 2; k <= n; ++k)
+                        f *= Integer(static_cast<long long>(k));
+                    keep(f.isZero());
+                });
+
+        // n! as a balanced product tree.
+        if (selected("Workload/factorial_tree"))
+            for (std::size_t n : {100, 1000, 10000, 1000000})
+            {
+                std::vector<Integer> factors;
+                for (std::size_t k = 2; k <= n; ++k)
+                    factors.emplace_back(static_cast<long long>(k));
+                add("Workload/factorial_tree", n, [factors] {
+                    keep(Integer::product(factors).isZero());
+                });
+            }
+
+        // d-digit base, exponent and modulus through a prepared
+        // Modulus: Montgomery for the odd modulus, Barrett for the
+        // even one.
+        for (const char *name :
+             {"Workload/powmod_odd", "Workload/powmod_even"})
+            if (selected(name))
+                for (std::size_t d : {100, 300, 1000})
+                {
+                    std::mt19937_64 rng(3);
+                    Integer b = randomInteger(d, rng);
+                    Integer e = randomInteger(d, rng);
+                    Integer m = randomInteger(d, rng);
+                    bool odd = !(m % Integer(2LL)).isZero();
+                    if (odd != (std::string(name) == "Workload/powmod_odd"))
+                        m += Integer(1LL);
+                    Modulus mod(m);
+                    add(name, d, [&] {
+                        keep(mod.pow(b, e).isZero());
+                    });
+                }
+
+        // Writing n mixed-size Integers and summing them back
+        // through in-place views.
+        if (selected("Workload/serialize"))
+            for (std::size_t n : {1000, 100000})
+            {
+                std::mt19937_64 rng(5);
+                std::vector<Integer> values;
+                for (std::size_t k = 0; k < n; ++k)
+                    values.push_back(randomInteger(1 + rng() % 60, rng));
+                add("Workload/serialize", n, [&] {
+                    serial::Buffer buffer;
+                    serial::serialize(buffer, values);
+                    serial::Reader reader(buffer.data(), buffer.size());
+                    Integer total;
+                    for (std::uint64_t k = reader.header(serial::Kind::Integer);
+                         k > 0; --k)
+                        total = total + reader.next();
+                    keep(total.isZero());
+                });
+            }
+
+        // Streaming sum and max of n word-sized fractions read
+        // from a mapped store file.
+        for (const char *name : {"Workload/store_sum", "Workload/store_max"})
+            if (selected(name))
+                for (std::size_t n : {100000, 1000000})
+                {
+                    std::mt19937_64 rng(6);
+                    const char *path = "benchmark_store.tmp";
+                    {
+                        RationalStore::Writer writer(path);
+                        for (std::size_t k = 0; k < n; ++k)
+                            writer.append(Rational(
+                                Integer(static_cast<long long>(rng() % 2000001) - 1000000),
+                                Integer(static_cast<long long>(rng() % 1000 + 1))));
+                        writer.close();
+                    }
+                    {
+                        RationalStore store(path);
+                        bool sum = std::string(name) == "Workload/store_sum";
+                        add(name, n, [&] {
+                            Rational r = sum ? store.sum() : store.max();
+                            keep(r.numerator().isZero());
+                        });
+                    }
+                    std::remove(path);
+                }
+
+        // Element-wise sums and products of n word-sized values
+        // in batches: 32-bit Integers, and prices times
+        // quantities as Rationals.
+        for (const char *name : {"Workload/batch_add", "Workload/batch_mul",
+                                 "Workload/rational_batch_mul"})
+            if (selected(name))
+                for (std::size_t n : {1000, 1000000})
+                {
+                    std::mt19937_64 rng(7);
+                    std::string op = name;
+                    if (op == "Workload/rational_batch_mul")
+                    {
+                        RationalBatch a, b;
+                        for (std::size_t k = 0; k < n; ++k)
+                        {
+                            a.append(Rational(
+                                Integer(static_cast<long long>(rng() % 100000)),
+                                Integer(100LL)));
+                            b.append(Rational(
+                                Integer(static_cast<long long>(rng() % 1000 + 1)),
+                                Integer(static_cast<long long>(rng() % 12 + 1))));
+                        }
+                        add(name, n, [&] { keep((a * b).isWord(0)); });
+                        continue;
+                    }
+                    IntegerBatch a, b;
+                    for (std::size_t k = 0; k < n; ++k)
+                    {
+                        a.append(static_cast<long long>(rng() % 2000000000) - 1000000000);
+                        b.append(static_cast<long long>(rng() % 2000000000) - 1000000000);
+                    }
+                    if (op == "Workload/batch_add")
+                        add(name, n, [&] { keep((a + b).isWord(0)); });
+                    else
+                        add(name, n, [&] { keep((a * b).isWord(0)); });
+                }
+
+        // Sorting n word-sized fractions.
+        if (selected("Workload/sort"))
+            for (std::size_t n : {1000, 100000, 1000000})
+            {
+                std::mt19937_64 rng(4);
+                std::vector<Rational> values;
+                for (std::size_t k = 0; k < n; ++k)
+                    values.emplace_back(
+                        Integer(static_cast<long long>(rng() % 2000001) - 1000000),
+                        Integer(static_cast<long long>(rng() % 1000000 + 1)));
+                add("Workload/sort", n, [&] {
+                    std::vector<Rational> v = values;
+                    std::sort(v.begin(), v.end());
+                    keep(v.front().numerator().isZero());
+                });
+            }
+
+        // n-th convergent of sqrt(2) = [1; 2, 2, 2, ...].
+        if (selected("Workload/continued_fraction"))
+            for (std::size_t n : {100, 1000, 10000})
+                add("Workload/continued_fraction", n, [n] {
+                    Rational x;
+                    Rational one(1LL), two(2LL);
+                    for (std::size_t k = 0; k < n; ++k)
+                        x = one / (two + x);
+                    x += one;
+                    keep(x.numerator().isZero());
+                });
+    }
+};
+
+// ---------------------------------------------------------
+// parseOptions(argc,argv)
+// Exits with a usage message on an unknown option.
+// ---------------------------------------------------------
+static Options parseOptions(int argc, char **argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *arg = argv[i];
+        const char *eq = std::strchr(arg, '=');
+        std::string key(arg, eq ? eq - arg : std::strlen(arg));
+        const char *value = eq ? eq + 1 : "";
+        std::size_t number = std::strtoull(value, nullptr, 10);
+
+        if (key == "--format")
+            options.format = value;
+        else if (key == "--filter")
+            options.filter = value;
+        else if (key == "--max-digits")
+            options.maxDigits = number;
+        else if (key == "--min-time")
+            options.minTime = std::strtod(value, nullptr);
+        else if (key == "--karatsuba")
+            Integer::multiplyThresholds().karatsuba = number;
+        else if (key == "--toom3")
+            Integer::multiplyThresholds().toom3 = number;
+        else if (key == "--ntt")
+            Integer::multiplyThresholds().ntt = number;
+        else if (key == "--square-karatsuba")
+            Integer::multiplyThresholds().squareKaratsuba = number;
+        else if (key == "--square-toom3")
+            Integer::multiplyThresholds().squareToom3 = number;
+        else if (key == "--square-ntt")
+            Integer::multiplyThresholds().squareNtt = number;
+        else if (key == "--parallel")
+            Integer::multiplyThresholds().parallel = number;
+        else if (key == "--threads")
+            Integer::multiplyThresholds().threads = number;
+        else if (key == "--divide-dc")
+            Integer::divideThresholds().divideAndConquer = number;
+        else if (key == "--newton")
+            Integer::divideThresholds().newton = number;
+        else if (key == "--half-gcd")
+            Integer::gcdThresholds().halfGcd = number;
+        else
+        {
+            std::fprintf(stderr, "unknown option %s (see the header of "
+                                 "bench/Benchmark.cpp)\n", arg);
+            std::exit(EXIT_FAILURE);
+        }
+    }
+    if (options.format != "console" && options.format != "json"
+        && options.format != "csv")
+    {
+        std::fprintf(stderr, "unknown format %s\n", options.format.c_str());
+        std::exit(EXIT_FAILURE);
+    }
+    return options;
+}
+
+int main(int argc, char **argv)
+{
+    Options options = parseOptions(argc, argv);
+    printHeader(options);
+
+    Suite suite{options};
+    suite.integerSweep();
+    suite.rationalSweep();
+    suite.workloads();
+
+    printFooter(options);
+    return 0;
+}
@@ -0,0 +1,1367 @@
+// ---------------------------------------------------------
+// File: tests/IntegerTests.cpp
+// Correctness suite for Integer, Rational and the containers
+// built on them.
+//
+// Author: agent <agent@local>
+// Last Modification: 2026-10-16
+//
+// Build from the repository root together with every library
+// source except main.cpp, e.g.:
+//   g++ -std=c++17 -O2 -I. tests/IntegerTests.cpp
+//       $(ls *.cpp | grep -v main.cpp) -pthread -o tests
+//
+// Options:
+//   --filter=TEXT   run suites whose "config/suite" name
+//                   contains TEXT
+//
+// Every suite runs once per threshold configuration: the
+// defaults; "schoolbook", with every crossover out of reach;
+// and "lowered" and "lowered-ntt", which bring Karatsuba,
+// Toom-3, divide-and-conquer division, half-GCD, the parallel
+// paths and (in the latter) the NTT and Newton division down
+// to a few limbs, so small operands run through the
+// subquadratic code. Results are checked against a plain
+// schoolbook implementation on 32-bit words kept in this file
+// (the reference), against identities that define the result
+// (a == q*b + r), or against results known in closed form.
+// Failures are printed; the exit status is nonzero if any
+// check failed.
+// ---------------------------------------------------------
+
+#include "Integer.h"
+#include "IntegerBatch.h"
+#include "Modulus.h"
+#include "Rational.h"
+#include "RationalStore.h"
+#include "Serialize.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// ---------------------------------------------------------
+// Checks
+// ---------------------------------------------------------
+static unsigned long long checks = 0;
+static unsigned long long failures = 0;
+static std::string current;  // "config/suite" being run
+
+static void check(bool ok, const std::string &what)
+{
+    ++checks;
+    if (ok)
+        return;
+    // The first few failures of a run are enough to go on.
+    if (++failures <= 50)
+        std::printf("FAIL %s: %s\n", current.c_str(), what.c_str());
+}
+
+// True if f() throws an E.
+template <typename E>
+static bool throws(const std::function<void()> &f)
+{
+    try
+    {
+        f();
+    }
+    catch (const E &)
+    {
+        return true;
+    }
+    catch (...)
+    {
+        return false;
+    }
+    return false;
+}
+
+static std::string str(std::size_t n)
+{
+    return std::to_string(n);
+}
+
+// ---------------------------------------------------------
+// Reference naturals
+// Magnitudes as vectors of 32-bit words, least significant
+// first, without leading zero words; zero is empty. Every
+// operation is the textbook quadratic loop, sharing no code
+// with the library.
+// ---------------------------------------------------------
+using Word = std::uint32_t;
+using Nat = std::vector<Word>;
+
+static void trim(Nat &a)
+{
+    while (!a.empty() && a.back() == 0)
+        a.pop_back();
+}
+
+static int compare(const Nat &a, const Nat &b)
+{
+    if (a.size() != b.size())
+        return a.size() < b.size() ? -1 : 1;
+    for (std::size_t i = a.size(); i-- > 0;)
+        if (a[i] != b[i])
+            return a[i] < b[i] ? -1 : 1;
+    return 0;
+}
+
+static Nat add(const Nat &a, const Nat &b)
+{
+    Nat r(std::max(a.size(), b.size()) + 1);
+    std::uint64_t carry = 0;
+    for (std::size_t i = 0; i < r.size(); ++i)
+    {
+        carry += (i < a.size() ? a[i] : 0);
+        carry += (i < b.size() ? b[i] : 0);
+        r[i] = static_cast<Word>(carry);
+        carry >>= 32;
+    }
+    trim(r);
+    return r;
+}
+
+// Preconditions: a >= b.
+static Nat sub(const Nat &a, const Nat &b)
+{
+    Nat r(a.size());
+    std::int64_t borrow = 0;
+    for (std::size_t i = 0; i < a.size(); ++i)
+    {
+        std::int64_t d = std::int64_t(a[i]) - (i < b.size() ? b[i] : 0)
+                         - borrow;
+        borrow = d < 0;
+        r[i] = static_cast<Word>(d + (borrow << 32));
+    }
+    trim(r);
+    return r;
+}
+
+static Nat mul(const Nat &a, const Nat &b)
+{
+    if (a.empty() || b.empty())
+        return Nat();
+    Nat r(a.size() + b.size());
+    for (std::size_t i = 0; i < a.size(); ++i)
+    {
+        std::uint64_t carry = 0;
+        for (std::size_t j = 0; j < b.size(); ++j)
+        {
+            carry += std::uint64_t(a[i]) * b[j] + r[i + j];
+            r[i + j] = static_cast<Word>(carry);
+            carry >>= 32;
+        }
+        r[i + b.size()] = static_cast<Word>(carry);
+    }
+    trim(r);
+    return r;
+}
+
+// a /= d in place; returns a % d. Preconditions: d != 0.
+static Word divSmall(Nat &a, Word d)
+{
+    std::uint64_t rem = 0;
+    for (std::size_t i = a.size(); i-- > 0;)
+    {
+        std::uint64_t cur = rem << 32 | a[i];
+        a[i] = static_cast<Word>(cur / d);
+        rem = cur % d;
+    }
+    trim(a);
+    return static_cast<Word>(rem);
+}
+
+static bool bit(const Nat &a, std::size_t i)
+{
+    return i / 32 < a.size() && (a[i / 32] >> (i % 32) & 1);
+}
+
+static std::size_t bitLength(const Nat &a)
+{
+    if (a.empty())
+        return 0;
+    std::size_t n = 32 * a.size();
+    while (!bit(a, n - 1))
+        --n;
+    return n;
+}
+
+// Digits of a in base 2..36, lowercase, "0" for zero.
+static std::string digits(Nat a, unsigned base)
+{
+    if (a.empty())
+        return "0";
+    std::string s;
+    // Power-of-two bases read the bits directly, so the bridge
+    // below stays linear.
+    if ((base & (base - 1)) == 0)
+    {
+        unsigned bits = 0;
+        while (1u << bits < base)
+            ++bits;
+        for (std::size_t i = 0; i < bitLength(a); i += bits)
+        {
+            unsigned d = 0;
+            for (unsigned j = 0; j < bits; ++j)
+                d |= unsigned(bit(a, i + j)) << j;
+            s.push_back("0123456789abcdef"[d]);
+        }
+        std::reverse(s.begin(), s.end());
+        return s;
+    }
+    // Peel off base^k at a time, the largest power below 2^32.
+    Word chunk = base;
+    unsigned k = 1;
+    while (std::uint64_t(chunk) * base <= 0xFFFFFFFFu)
+    {
+        chunk *= base;
+        ++k;
+    }
+    while (!a.empty())
+    {
+        Word r = divSmall(a, chunk);
+        for (unsigned i = 0; i < k && (r || !a.empty() || i == 0); ++i)
+        {
+            s.push_back("0123456789abcdefghijklmnopqrstuvwxyz"[r % base]);
+            r /= base;
+        }
+    }
+    std::reverse(s.begin(), s.end());
+    return s;
+}
+
+// ---------------------------------------------------------
+// Bridge between the reference and Integer
+// Goes through hexadecimal strings, which testConversion()
+// checks against Horner's rule on words.
+// ---------------------------------------------------------
+static Integer toInteger(const Nat &a, bool negative = false)
+{
+    return Integer((negative ? "-" : "") + digits(a, 16), 16);
+}
+
+static Nat toNat(const Integer &x)
+{
+    std::string s = x.abs().toString(16);
+    Nat a((s.size() + 7) / 8);
+    for (std::size_t i = 0; i < s.size(); ++i)
+    {
+        char c = s[s.size() - 1 - i];
+        Word v = c <= '9' ? c - '0' : c - 'a' + 10;
+        a[i / 8] |= v << (4 * (i % 8));
+    }
+    trim(a);
+    return a;
+}
+
+// 2^n, built without shifts.
+static Integer powerOfTwo(std::size_t n)
+{
+    std::string s(1 + n / 4, '0');
+    s[0] = "1248"[n % 4];
+    return Integer(s, 16);
+}
+
+// ---------------------------------------------------------
+// Operands
+// ---------------------------------------------------------
+static std::mt19937_64 rng(20261016);
+
+// A natural of exactly the given number of 64-bit limbs.
+// Besides uniform words, a quarter of the values are mostly
+// all-ones words and a quarter mostly zero words, the
+// patterns that carry and borrow furthest.
+static Nat randomNat(std::size_t limbs)
+{
+    Nat a(2 * limbs);
+    unsigned kind = rng() % 4;
+    for (Word &w : a)
+    {
+        w = static_cast<Word>(rng());
+        if (kind == 1 && rng() % 8)
+            w = 0xFFFFFFFFu;
+        else if (kind == 2 && rng() % 8)
+            w = 0;
+    }
+    if (limbs)
+        a.back() |= Word(1) << (rng() % 32);
+    return a;
+}
+
+static Integer randomInteger(std::size_t limbs, bool mayBeNegative = true)
+{
+    return toInteger(randomNat(limbs), mayBeNegative && rng() % 2);
+}
+
+// Signed reference values are a sign and a Nat.
+struct Signed
+{
+    bool negative;
+    Nat magnitude;
+};
+
+static Signed addSigned(const Signed &a, const Signed &b)
+{
+    Signed r;
+    if (a.negative == b.negative)
+        r = {a.negative, add(a.magnitude, b.magnitude)};
+    else if (compare(a.magnitude, b.magnitude) >= 0)
+        r = {a.negative, sub(a.magnitude, b.magnitude)};
+    else
+        r = {b.negative, sub(b.magnitude, a.magnitude)};
+    r.negative = r.negative && !r.magnitude.empty();
+    return r;
+}
+
+static Integer toInteger(const Signed &a)
+{
+    return toInteger(a.magnitude, a.negative);
+}
+
+static Signed toSigned(const Integer &x)
+{
+    return {x.isNegative(), toNat(x)};
+}
+
+// ---------------------------------------------------------
+// Conversion
+// ---------------------------------------------------------
+static void testConversion()
+{
+    // The hexadecimal bridge, against Horner's rule.
+    for (std::size_t n : {0, 1, 2, 3, 17, 100, 1000})
+    {
+        Nat a = randomNat(n);
+        Integer x;
+        for (std::size_t i = a.size(); i-- > 0;)
+            x = x * Integer(1LL << 32) + Integer(static_cast<long long>(a[i]));
+        check(Integer(digits(a, 16), 16) == x, "parse hex, " + str(n) + " limbs");
+        check(x.toString(16) == digits(a, 16), "print hex, " + str(n) + " limbs");
+    }
+
+    for (std::size_t n : {0, 1, 2, 3, 5, 17, 29, 30, 31, 64, 100, 257, 1000, 3100})
+        for (unsigned base : {2, 3, 7, 10, 16, 36})
+        {
+            if (n > 1000 && base != 10)
+                continue;
+            bool negative = n && rng() % 2;
+            Nat a = randomNat(n);
+            Integer x = toInteger(a, negative);
+            std::string expected = (negative ? "-" : "") + digits(a, base);
+            std::string what = str(n) + " limbs, base " + str(base);
+            check(x.toString(base) == expected, "toString, " + what);
+            check(Integer(expected, base) == x, "parse, " + what);
+            std::string upper = expected;
+            for (char &c : upper)
+                c = static_cast<char>(std::toupper(c));
+            check(Integer(upper, base) == x, "parse uppercase, " + what);
+            if (base == 10)
+            {
+                std::ostringstream os;
+                os << x;
+                check(os.str() == expected, "operator<<, " + what);
+
+                // Base-100 digit constructors, least significant first.
+                std::string d = digits(a, 10);
+                std::vector<unsigned char> v;
+                for (std::size_t end = d.size(); end > 0;)
+                {
+                    std::size_t begin = end >= 2 ? end - 2 : 0;
+                    v.push_back(static_cast<unsigned char>(
+                        std::stoi(d.substr(begin, end - begin))));
+                    end = begin;
+                }
+                check(Integer(negative, v) == x, "base-100 vector, " + what);
+                std::string raw(v.begin(), v.end());
+                check(Integer(negative, static_cast<int>(raw.size()), raw.data()) == x,
+                      "base-100 array, " + what);
+            }
+        }
+
+    std::ostringstream os;
+    os << std::hex << std::showbase << std::uppercase << Integer(-255);
+    check(os.str() == "-0XFF", "operator<< hex " + os.str());
+    os.str("");
+    os << std::oct << Integer(8);
+    check(os.str() == "010", "operator<< oct " + os.str());
+
+    check(Integer("0x1f", 16) == Integer(31), "0x prefix");
+    check(Integer("0b101", 2) == Integer(5), "0b prefix");
+    check(Integer("+42") == Integer(42), "plus sign");
+    check(Integer("-0").isZero() && !Integer("-0").isNegative(), "negative zero");
+    for (const char *bad : {"", "-", "+", "12a", "0x", " 1", "1 ", "--1"})
+        check(throws<std::invalid_argument>([bad] { Integer x(bad); }),
+              std::string("malformed \"") + bad + "\"");
+    check(throws<std::invalid_argument>([] { Integer x("1", 1); }), "base 1");
+    check(throws<std::invalid_argument>([] { Integer x("1", 37); }), "base 37");
+    check(throws<std::invalid_argument>([] { Integer(1).toString(37); }),
+          "toString base 37");
+
+    // Conversions to double round to nearest, ties to even;
+    // fromDouble() is exact.
+    check(powerOfTwo(53).toDouble() == 9007199254740992.0, "toDouble 2^53");
+    check((powerOfTwo(53) + Integer(1)).toDouble() == 9007199254740992.0,
+          "toDouble 2^53 + 1 ties to even");
+    check((powerOfTwo(53) + Integer(3)).toDouble() == 9007199254740996.0,
+          "toDouble 2^53 + 3 ties to even");
+    check(std::isinf(powerOfTwo(1024).toDouble()), "toDouble 2^1024");
+    int exponent;
+    double mantissa = std::frexp(1e300, &exponent);
+    Integer exact = Integer(static_cast<long long>(std::ldexp(mantissa, 53)))
+                    * powerOfTwo(exponent - 53);
+    check(Integer::fromDouble(-1e300) == -exact, "fromDouble -1e300");
+    check(Integer::fromDouble(-2.75) == Integer(-2), "fromDouble truncates");
+    check(throws<std::invalid_argument>([] { Integer::fromDouble(NAN); }),
+          "fromDouble NaN");
+}
+
+// ---------------------------------------------------------
+// Addition and multiplication
+// ---------------------------------------------------------
+static void testAddition()
+{
+    for (std::size_t n : {0, 1, 2, 3, 17, 100, 1000})
+        for (std::size_t m : {0, 1, 2, 5, 100})
+        {
+            Signed a = toSigned(randomInteger(n)), b = toSigned(randomInteger(m));
+            Integer x = toInteger(a), y = toInteger(b);
+            Signed nb{!b.negative && !b.magnitude.empty(), b.magnitude};
+            Integer sum = toInteger(addSigned(a, b));
+            Integer difference = toInteger(addSigned(a, nb));
+            std::string what = str(n) + " and " + str(m) + " limbs";
+            check(x + y == sum, "+, " + what);
+            check(x - y == difference, "-, " + what);
+            Integer t = x;
+            t += y;
+            check(t == sum, "+=, " + what);
+            t = x;
+            t -= y;
+            check(t == difference, "-=, " + what);
+            Integer u = x;
+            check(std::move(u) + y == sum, "rvalue +, " + what);
+            t = x;
+            t -= t;
+            check(t.isZero(), "x -= x, " + what);
+        }
+}
+
+static void testMultiplication()
+{
+    const std::size_t pairs[][2] = {
+        {1, 1}, {1, 5}, {2, 2}, {3, 7}, {5, 5}, {8, 8}, {17, 17}, {31, 33},
+        {32, 32}, {33, 17}, {64, 64}, {100, 100}, {161, 160}, {257, 250},
+        {600, 200}, {1000, 1000}, {1000, 30}, {3100, 3100}, {5000, 1200}};
+    for (const auto &p : pairs)
+    {
+        std::string what = str(p[0]) + " x " + str(p[1]) + " limbs";
+        Signed a = toSigned(randomInteger(p[0])), b = toSigned(randomInteger(p[1]));
+        Signed c{a.negative != b.negative, mul(a.magnitude, b.magnitude)};
+        Integer x = toInteger(a), y = toInteger(b), product = toInteger(c);
+        check(x * y == product, "*, " + what);
+        check(y * x == product, "* commuted, " + what);
+        Integer t = x;
+        t *= y;
+        check(t == product, "*=, " + what);
+
+        Integer z = randomInteger(p[0] + p[1]);
+        t = z;
+        t.addMul(x, y);
+        check(t == z + product, "addMul, " + what);
+        t = z;
+        t.subMul(x, y);
+        check(t == z - product, "subMul, " + what);
+    }
+
+    for (std::size_t n : {1, 2, 5, 17, 31, 48, 49, 100, 250, 251, 600, 3100, 6100})
+    {
+        std::string what = str(n) + " limbs";
+        Nat a = randomNat(n);
+        Integer x = toInteger(a, rng() % 2), square = toInteger(mul(a, a));
+        check(x * x == square, "x * x, " + what);
+        check(x.square() == square, "square(), " + what);
+    }
+
+    std::vector<Integer> values;
+    Signed product{false, Nat{1}}, sum{false, Nat()};
+    for (int i = 0; i < 60; ++i)
+    {
+        values.push_back(randomInteger(1 + rng() % 40));
+        Signed v = toSigned(values.back());
+        product = {product.negative != v.negative, mul(product.magnitude, v.magnitude)};
+        sum = addSigned(sum, v);
+    }
+    check(Integer::product(values) == toInteger(product), "product()");
+    check(Integer::sum(values) == toInteger(sum), "sum()");
+    check(Integer::product(std::vector<Integer>()) == Integer(1), "empty product");
+    check(Integer::sum(std::vector<Integer>()).isZero(), "empty sum");
+}
+
+// ---------------------------------------------------------
+// Division
+// ---------------------------------------------------------
+
+// Checks x / y and x % y against q and r, the truncated
+// quotient and remainder.
+static void checkDivision(const Integer &x, const Integer &y, const Integer &q,
+                          const Integer &r, const std::string &what)
+{
+    check(x / y == q, "/, " + what);
+    check(x % y == r, "%, " + what);
+    std::pair<Integer, Integer> qr = x.divmod(y);
+    check(qr.first == q && qr.second == r, "divmod, " + what);
+    Integer t = x;
+    t /= y;
+    check(t == q, "/=, " + what);
+    t = x;
+    t %= y;
+    check(t == r, "%=, " + what);
+}
+
+static void testDivision()
+{
+    const std::size_t pairs[][2] = {
+        {1, 1}, {2, 1}, {3, 2}, {5, 3}, {8, 8}, {17, 5}, {33, 32}, {64, 20},
+        {100, 61}, {200, 100}, {400, 130}, {1000, 999}, {1000, 61},
+        {2100, 1000}, {6000, 3000}, {24000, 12000}};
+    for (const auto &p : pairs)
+        for (int round = 0; round < 2; ++round)
+        {
+            std::string what = str(p[0]) + " / " + str(p[1]) + " limbs";
+            // a = q*d + r with 0 <= r < d, so a / d is q and
+            // a % d is r; the signs follow truncation.
+            Integer d = randomInteger(p[1], false);
+            if (round == 1)
+                d = powerOfTwo(64 * p[1] - 1) + Integer(rng() % 2);
+            Integer q = randomInteger(p[0] - p[1] + 1, false);
+            Integer r = rng() % 4 == 0 ? d - Integer(1)
+                        : p[1] > 1 ? randomInteger(p[1] - 1, false) : Integer();
+            Integer a = q * d + r;
+            checkDivision(a, d, q, r, what);
+            check(a.divmod(-d) == std::make_pair(-q, r), "negative divisor, " + what);
+            check((-a).divmod(d) == std::make_pair(-q, -r), "negative dividend, " + what);
+            check((-a).divmod(-d) == std::make_pair(q, -r), "both negative, " + what);
+            check((d - Integer(1)).divmod(d) == std::make_pair(Integer(), d - Integer(1)),
+                  "dividend below divisor, " + what);
+
+            // Random operands satisfy the defining identity.
+            Integer x = randomInteger(p[0]), y = randomInteger(p[1]);
+            std::pair<Integer, Integer> qr = x.divmod(y);
+            check(qr.first * y + qr.second == x, "x == q*y + r, " + what);
+            check(qr.second.abs() < y.abs(), "|r| < |y|, " + what);
+            check(qr.second.isZero() || qr.second.isNegative() == x.isNegative(),
+                  "sign of r, " + what);
+        }
+
+    // Word divisors against the reference.
+    for (std::size_t n : {1, 2, 10, 300})
+    {
+        Nat a = randomNat(n);
+        Word d = static_cast<Word>(rng()) | 1;
+        Nat q = a;
+        Word r = divSmall(q, d);
+        checkDivision(toInteger(a), Integer(static_cast<long long>(d)), toInteger(q),
+                      Integer(static_cast<long long>(r)),
+                      "word divisor, " + str(n) + " limbs");
+    }
+
+    for (const char *op : {"/", "%", "divmod"})
+        check(throws<std::domain_error>([op] {
+                  Integer x(5), zero;
+                  if (*op == '/')
+                      x / zero;
+                  else if (*op == '%')
+                      x % zero;
+                  else
+                      x.divmod(zero);
+              }),
+              std::string(op) + " by zero");
+}
+
+// ---------------------------------------------------------
+// GCD
+// ---------------------------------------------------------
+static Integer euclid(Integer a, Integer b)
+{
+    a = a.abs();
+    b = b.abs();
+    while (!b.isZero())
+    {
+        Integer r = a % b;
+        a = std::move(b);
+        b = std::move(r);
+    }
+    return a;
+}
+
+static Integer fibonacci(std::size_t n)
+{
+    Integer a, b(1);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        a += b;
+        std::swap(a, b);
+    }
+    return a;
+}
+
+static void testGcd()
+{
+    const std::size_t pairs[][2] = {
+        {1, 1}, {2, 1}, {2, 2}, {3, 3}, {10, 9}, {40, 40}, {100, 97},
+        {400, 400}, {800, 780}};
+    for (const auto &p : pairs)
+    {
+        std::string what = str(p[0]) + " and " + str(p[1]) + " limbs";
+        Integer a = randomInteger(p[0]), b = randomInteger(p[1]);
+        check(Integer::gcd(a, b) == euclid(a, b), "random, " + what);
+        // A large common factor, so the result is not 1.
+        Integer g = randomInteger(1 + p[1] / 2, false);
+        Integer ga = a * g, gb = b * g;
+        check(Integer::gcd(ga, gb) == euclid(ga, gb), "common factor, " + what);
+        check(Integer::gcd(ga, gb) == Integer::gcd(gb, ga), "symmetric, " + what);
+    }
+
+    // Two-limb operands with a one-limb gcd.
+    for (int i = 0; i < 200; ++i)
+    {
+        Integer g = randomInteger(1, false);
+        Integer a = g * Integer(static_cast<long long>(rng() >> 2) + 1);
+        Integer b = g * Integer(static_cast<long long>(rng() >> 2) + 1);
+        check(Integer::gcd(a, b) == euclid(a, b), "two limbs, one-limb gcd");
+    }
+
+    // gcd(F(m), F(n)) == F(gcd(m, n)); consecutive Fibonacci
+    // numbers are the slowest case for Euclid's algorithm.
+    check(Integer::gcd(fibonacci(6000), fibonacci(9000)) == fibonacci(3000),
+          "gcd(F6000, F9000)");
+    check(Integer::gcd(fibonacci(40000), fibonacci(40001)) == Integer(1),
+          "gcd(F40000, F40001)");
+
+    Integer a = randomInteger(50, false);
+    check(Integer::gcd(Integer(), Integer()).isZero(), "gcd(0, 0)");
+    check(Integer::gcd(-a, Integer()) == a, "gcd(-a, 0)");
+    check(Integer::gcd(Integer(), a) == a, "gcd(0, a)");
+    check(Integer::gcd(a, -a) == a, "gcd(a, -a)");
+}
+
+// ---------------------------------------------------------
+// Powers
+// ---------------------------------------------------------
+static Integer powmodReference(Integer base, Integer exp, const Integer &m)
+{
+    Integer r = Integer(1) % m;
+    base %= m;
+    if (base.isNegative())
+        base += m;
+    for (; !exp.isZero(); exp = exp / Integer(2))
+    {
+        if (!(exp % Integer(2)).isZero())
+            r = r * base % m;
+        base = base * base % m;
+    }
+    return r;
+}
+
+static void testPower()
+{
+    for (std::size_t n : {1, 2, 3})
+        for (std::uint64_t e : {0, 1, 2, 3, 7, 16, 41})
+        {
+            Nat a = randomNat(n);
+            bool negative = rng() % 2;
+            Nat p{1};
+            for (std::uint64_t i = 0; i < e; ++i)
+                p = mul(p, a);
+            check(Integer::pow(toInteger(a, negative), e) == toInteger(p, negative && e % 2),
+                  "pow, " + str(n) + " limbs ^ " + str(e));
+        }
+
+    Nat three{3}, p{1};
+    for (int i = 0; i < 20000; ++i)
+        p = mul(p, three);
+    check(Integer::pow(Integer(3), 20000) == toInteger(p), "3^20000");
+    check(Integer::pow(Integer(6), 20000) == toInteger(p) * powerOfTwo(20000),
+          "6^20000");
+    for (std::size_t k : {0, 1, 63, 64, 65, 1000})
+        check(Integer::pow(Integer(2), k) == powerOfTwo(k), "2^" + str(k));
+    check(Integer::pow(Integer(), 0) == Integer(1), "0^0");
+    check(Integer::pow(Integer(), 5).isZero(), "0^5");
+    check(Integer::pow(Integer(-1), 12345) == Integer(-1), "(-1)^12345");
+
+    for (std::size_t n : {1, 2, 3, 8, 40, 130})
+        for (int parity = 0; parity < 3; ++parity)
+        {
+            // Odd moduli take the Montgomery path, even ones
+            // Barrett's; the last is a power of two.
+            Integer m = randomInteger(n, false);
+            if (parity == 0 && (m % Integer(2)).isZero())
+                m += Integer(1);
+            else if (parity == 1 && !(m % Integer(2)).isZero())
+                m += Integer(1);
+            else if (parity == 2)
+                m = powerOfTwo(64 * n - 7);
+            Modulus mod(m);
+            for (std::size_t en : {0, 1, 4})
+            {
+                std::string what = str(n) + "-limb modulus, " + str(en)
+                                   + "-limb exponent, case " + str(parity);
+                Integer base = randomInteger(n + 1);
+                Integer exp = randomInteger(en, false);
+                Integer expected = powmodReference(base, exp, m);
+                check(Integer::powmod(base, exp, m) == expected, "powmod, " + what);
+                check(mod.pow(base, exp) == expected, "Modulus::pow, " + what);
+            }
+            Integer a = randomInteger(n + 2), b = randomInteger(n, false) % m;
+            Integer r = a % m;
+            if (r.isNegative())
+                r += m;
+            check(mod.reduce(a) == r, "Modulus::reduce, " + str(n) + " limbs");
+            check(mod.multiply(r, b) == r * b % m,
+                  "Modulus::multiply, " + str(n) + " limbs");
+            check(mod.square(r) == r * r % m, "Modulus::square, " + str(n) + " limbs");
+        }
+
+    check(Integer::powmod(Integer(5), Integer(3), Integer(1)).isZero(), "mod 1");
+    check(throws<std::domain_error>([] { Integer::powmod(Integer(2), Integer(3), Integer()); }),
+          "powmod mod 0");
+    check(throws<std::domain_error>([] { Integer::powmod(Integer(2), Integer(3), Integer(-7)); }),
+          "powmod negative modulus");
+    check(throws<std::domain_error>([] { Integer::powmod(Integer(2), Integer(-3), Integer(7)); }),
+          "powmod negative exponent");
+    check(throws<std::domain_error>([] { Modulus m{Integer()}; }), "Modulus(0)");
+}
+
+// ---------------------------------------------------------
+// Bitwise operations
+// Against the two's-complement words of the operands, taken
+// modulo 2^(32*words) for a width past both of them.
+// ---------------------------------------------------------
+static Nat twos(const Integer &x, std::size_t words)
+{
+    Nat a = toNat(x.isNegative() ? x + powerOfTwo(32 * words) : x);
+    a.resize(words);
+    return a;
+}
+
+static Integer fromTwos(Nat a)
+{
+    bool negative = a.back() >> 31;
+    std::size_t words = a.size();
+    trim(a);
+    Integer x = toInteger(a);
+    return negative ? x - powerOfTwo(32 * words) : x;
+}
+
+static void testBitwise()
+{
+    for (std::size_t n : {0, 1, 2, 3, 10, 33})
+        for (std::size_t m : {0, 1, 2, 10})
+        {
+            std::string what = str(n) + " and " + str(m) + " limbs";
+            Integer x = randomInteger(n), y = randomInteger(m);
+            std::size_t words = 2 * std::max(n, m) + 2;
+            Nat a = twos(x, words), b = twos(y, words);
+            Nat rand(words), ror(words), rxor(words), rnot(words);
+            for (std::size_t i = 0; i < words; ++i)
+            {
+                rand[i] = a[i] & b[i];
+                ror[i] = a[i] | b[i];
+                rxor[i] = a[i] ^ b[i];
+                rnot[i] = ~a[i];
+            }
+            check((x & y) == fromTwos(rand), "&, " + what);
+            check((x | y) == fromTwos(ror), "|, " + what);
+            check((x ^ y) == fromTwos(rxor), "^, " + what);
+            check(~x == fromTwos(rnot), "~, " + what);
+            Integer t = x;
+            t &= y;
+            check(t == fromTwos(rand), "&=, " + what);
+            t = x;
+            t |= y;
+            check(t == fromTwos(ror), "|=, " + what);
+            t = x;
+            t ^= y;
+            check(t == fromTwos(rxor), "^=, " + what);
+
+            for (std::size_t i : {std::size_t(0), std::size_t(rng() % (32 * words)),
+                                  32 * words - 1, 32 * words + 100})
+                check(x.testBit(i) == (i < 32 * words ? bit(a, i) : x.isNegative()),
+                      "testBit " + str(i) + ", " + what);
+
+            Nat magnitude = toNat(x);
+            std::size_t length = bitLength(magnitude), ones = 0;
+            std::uint64_t top = 0;
+            for (std::size_t i = 0; i < length; ++i)
+                ones += bit(magnitude, i);
+            for (std::size_t i = 0; i < 64; ++i)
+                if (length + i >= 64 && bit(magnitude, length + i - 64))
+                    top |= std::uint64_t(1) << i;
+            check(x.bitLength() == length, "bitLength, " + what);
+            check(x.popCount() == ones, "popCount, " + what);
+            check(x.topBits() == top, "topBits, " + what);
+        }
+
+    for (std::size_t n : {0, 1, 2, 5, 40})
+        for (std::size_t s : {0, 1, 31, 63, 64, 65, 127, 1000})
+        {
+            std::string what = str(n) + " limbs by " + str(s);
+            Integer x = randomInteger(n), p = powerOfTwo(s);
+            // floor(x / 2^s) from the truncated quotient.
+            Integer q = x / p;
+            if (x.isNegative() && q * p != x)
+                q -= Integer(1);
+            check((x << s) == x * p, "<<, " + what);
+            check((x >> s) == q, ">>, " + what);
+            Integer t = x;
+            t <<= s;
+            check(t == x * p, "<<=, " + what);
+            t = x;
+            t >>= s;
+            check(t == q, ">>=, " + what);
+        }
+    check((Integer(-1) >> 1000) == Integer(-1), "-1 >> 1000");
+}
+
+// ---------------------------------------------------------
+// Rational
+// Results are compared as values by cross-multiplying, and
+// must be in lowest terms with a positive denominator.
+// ---------------------------------------------------------
+static Rational randomRational(std::size_t numLimbs, std::size_t denLimbs)
+{
+    Integer d = randomInteger(denLimbs, false);
+    return Rational(randomInteger(numLimbs), d.isZero() ? Integer(1) : d);
+}
+
+static bool isValue(const Rational &r, const Integer &n, const Integer &d)
+{
+    return r.numerator() * d == n * r.denominator()
+           && r.denominator() > Integer()
+           && Integer::gcd(r.numerator(), r.denominator()) == Integer(1);
+}
+
+static void testRational()
+{
+    const std::size_t shapes[][2] = {
+        {0, 1}, {1, 1}, {1, 2}, {3, 1}, {5, 5}, {20, 20}, {60, 50}, {400, 400}};
+    for (const auto &s : shapes)
+        for (const auto &t : shapes)
+        {
+            std::string what = str(s[0]) + "/" + str(s[1]) + " and "
+                               + str(t[0]) + "/" + str(t[1]) + " limbs";
+            Rational x = randomRational(s[0], s[1]), y = randomRational(t[0], t[1]);
+            // A shared denominator factor, where the result
+            // needs reducing.
+            if (rng() % 2)
+            {
+                Integer g = randomInteger(1 + t[1] / 2, false);
+                y = Rational(y.numerator(), y.denominator() * g);
+                x = Rational(x.numerator(), x.denominator() * g);
+            }
+            const Integer &a = x.numerator(), &b = x.denominator();
+            const Integer &c = y.numerator(), &d = y.denominator();
+            check(isValue(x + y, a * d + c * b, b * d), "+, " + what);
+            check(isValue(x - y, a * d - c * b, b * d), "-, " + what);
+            check(isValue(x * y, a * c, b * d), "*, " + what);
+            check(isValue(x * x, a * a, b * b), "x * x, " + what);
+            if (!c.isZero())
+                check(isValue(x / y, a * d, b * c), "/, " + what);
+            Rational z = x;
+            z += y;
+            check(z == x + y, "+=, " + what);
+            z = x;
+            z -= y;
+            check(z == x - y, "-=, " + what);
+            z = x;
+            z *= y;
+            check(z == x * y, "*=, " + what);
+
+            int expected = (a * d - c * b).signum();
+            check(x.compare(y) == expected, "compare, " + what);
+            check((x < y) == (expected < 0) && (x >= y) == (expected >= 0)
+                      && (x == y) == (expected == 0),
+                  "ordering, " + what);
+        }
+
+    std::vector<Rational> values;
+    Integer n(0), d(1), pn(1), pd(1);
+    for (int i = 0; i < 50; ++i)
+    {
+        values.push_back(randomRational(rng() % 4, 1 + rng() % 3));
+        const Rational &v = values.back();
+        n = n * v.denominator() + v.numerator() * d;
+        d *= v.denominator();
+        pn *= v.numerator();
+        pd *= v.denominator();
+    }
+    check(isValue(Rational::sum(values), n, d), "sum()");
+    check(isValue(Rational::product(values), pn, pd), "product()");
+    check(Rational::sum(std::vector<Rational>()) == Rational(), "empty sum");
+    check(Rational::product(std::vector<Rational>()) == Rational(1LL), "empty product");
+
+    // n, d < 2^53 convert exactly, and so does their IEEE
+    // quotient: it is the correctly rounded value.
+    for (int i = 0; i < 1000; ++i)
+    {
+        long long p = static_cast<long long>(rng() >> 11) - (1LL << 52);
+        long long q = static_cast<long long>(rng() >> 11) + 1;
+        Rational r{Integer(p), Integer(q)};
+        check(r.toDouble() == double(p) / double(q), "toDouble " + str(i));
+        double v;
+        do
+        {
+            std::uint64_t bits = rng();
+            std::memcpy(&v, &bits, sizeof v);
+        } while (!std::isfinite(v));
+        check(Rational::fromDouble(v).toDouble() == v, "fromDouble round trip");
+    }
+    check(Rational::fromDouble(0.375) == Rational(Integer(3), Integer(8)), "fromDouble 0.375");
+
+    Rational pi = Rational::fromDouble(3.141592653589793);
+    check(pi.approximate(Integer(7)) == Rational(Integer(22), Integer(7)), "approximate 22/7");
+    check(pi.approximate(Integer(1000)) == Rational(Integer(355), Integer(113)),
+          "approximate 355/113");
+    // No fraction with a small denominator is closer.
+    for (int i = 0; i < 200; ++i)
+    {
+        Rational x{Integer(static_cast<long long>(rng() % 2000001) - 1000000),
+                   Integer(static_cast<long long>(rng() % 1000000 + 1))};
+        long long maxDen = 1 + rng() % 60;
+        Rational best = x.approximate(Integer(maxDen));
+        Rational bestError = best - x;
+        if (bestError < Rational())
+            bestError = -bestError;
+        bool ok = best.denominator() <= Integer(maxDen);
+        for (long long q = 1; q <= maxDen; ++q)
+        {
+            Integer floor = x.numerator() * Integer(q) / x.denominator();
+            for (long long k = -1; k <= 1; ++k)
+            {
+                Rational e = Rational(floor + Integer(k), Integer(q)) - x;
+                if (e < Rational())
+                    e = -e;
+                ok = ok && bestError <= e;
+            }
+        }
+        check(ok, "approximate, max denominator " + str(maxDen));
+    }
+}
+
+// ---------------------------------------------------------
+// Serialization
+// ---------------------------------------------------------
+static void putVarint(serial::Buffer &out, std::uint64_t x)
+{
+    for (; x >= 0x80; x >>= 7)
+        out.push_back(static_cast<unsigned char>(x | 0x80));
+    out.push_back(static_cast<unsigned char>(x));
+}
+
+// A bulk header and count as serialize() writes them.
+static serial::Buffer header(char kind, std::uint64_t count)
+{
+    serial::Buffer out = {'N', 'U', 'M', static_cast<unsigned char>(kind),
+                          serial::version, 0, 0, 0};
+    putVarint(out, count);
+    return out;
+}
+
+// Copies a buffer to limb-aligned storage for serial::Reader.
+static std::vector<Integer::Limb> aligned(const serial::Buffer &b)
+{
+    std::vector<Integer::Limb> limbs((b.size() + 7) / 8);
+    std::memcpy(limbs.data(), b.data(), b.size());
+    return limbs;
+}
+
+static void testSerialization()
+{
+    const Integer inlineLimit = powerOfTwo(61);
+    std::vector<Integer> integers = {
+        Integer(), Integer(1), Integer(-1), inlineLimit - Integer(1),
+        Integer(1) - inlineLimit, inlineLimit, -inlineLimit, powerOfTwo(63),
+        powerOfTwo(64) - Integer(1), powerOfTwo(64)};
+    for (std::size_t n : {1, 2, 3, 17, 100})
+        integers.push_back(randomInteger(n));
+
+    serial::Buffer buffer;
+    serial::serialize(buffer, integers);
+    check(serial::deserializeIntegers(buffer.data(), buffer.size()) == integers,
+          "Integer round trip");
+    serial::Buffer shifted(1);
+    shifted.insert(shifted.end(), buffer.begin(), buffer.end());
+    check(serial::deserializeIntegers(shifted.data() + 1, buffer.size()) == integers,
+          "unaligned Integer round trip");
+
+    std::vector<Integer::Limb> storage = aligned(buffer);
+    const unsigned char *data = reinterpret_cast<const unsigned char *>(storage.data());
+    serial::Reader reader(data, buffer.size());
+    check(reader.header(serial::Kind::Integer) == integers.size(), "Reader count");
+    bool same = true;
+    for (const Integer &x : integers)
+        same = same && reader.next() == IntegerView(x);
+    check(same && reader.atEnd(), "Reader views");
+
+    std::vector<Rational> rationals = {Rational(), Rational(-1LL),
+                                       Rational(Integer(1), inlineLimit)};
+    for (std::size_t n : {1, 2, 30})
+        rationals.push_back(randomRational(n, n));
+    serial::Buffer rbuffer;
+    serial::serialize(rbuffer, rationals);
+    check(serial::deserializeRationals(rbuffer.data(), rbuffer.size()) == rationals,
+          "Rational round trip");
+
+    // Every malformed buffer below is rejected.
+    auto rejects = [](const serial::Buffer &b, const std::string &what, bool rational) {
+        check(throws<std::invalid_argument>([&b, rational] {
+                  if (rational)
+                      serial::deserializeRationals(b.data(), b.size());
+                  else
+                      serial::deserializeIntegers(b.data(), b.size());
+              }),
+              what);
+    };
+    for (std::size_t n = 0; n < buffer.size(); ++n)
+        rejects(serial::Buffer(buffer.begin(), buffer.begin() + n),
+                "truncated to " + str(n) + " bytes", false);
+    rejects(rbuffer, "Rational buffer read as Integers", false);
+    rejects(buffer, "Integer buffer read as Rationals", true);
+    serial::Buffer b = buffer;
+    b.push_back(0);
+    rejects(b, "trailing byte", false);
+    b = buffer;
+    b[4] = serial::version + 1;
+    rejects(b, "other version", false);
+    b = buffer;
+    b[5] = 1;
+    rejects(b, "reserved header byte", false);
+
+    b = header('I', 1);
+    b.insert(b.end(), {0x84, 0x00});  // 1 with a redundant zero group
+    rejects(b, "overlong varint", false);
+    b = header('I', 1);
+    putVarint(b, std::uint64_t(1) << 63);  // inline payload 2^61
+    rejects(b, "inline payload at the limit", false);
+    b = header('I', 1);
+    putVarint(b, 1 << 2 | 2);  // one limb below the limit
+    b.resize((b.size() + 7) & ~std::size_t(7));
+    b.insert(b.end(), {5, 0, 0, 0, 0, 0, 0, 0});
+    rejects(b, "short magnitude in limb form", false);
+    b = header('I', 1);
+    putVarint(b, 1 << 2 | 2);
+    b.resize((b.size() + 7) & ~std::size_t(7), 1);
+    b.insert(b.end(), {0, 0, 0, 0, 0, 0, 0, 0x40});
+    rejects(b, "nonzero padding", false);
+
+    b = header('R', 1);
+    putVarint(b, 2 << 2);
+    putVarint(b, 4 << 2);
+    rejects(b, "2/4 not in lowest terms", true);
+    b = header('R', 1);
+    putVarint(b, 0);
+    putVarint(b, 3 << 2);
+    rejects(b, "0/3 not in lowest terms", true);
+    b = header('R', 1);
+    putVarint(b, 1 << 2);
+    putVarint(b, 0);
+    rejects(b, "zero denominator", true);
+    b = header('R', 1);
+    putVarint(b, 1 << 2);
+    putVarint(b, 3 << 2 | 1);
+    rejects(b, "negative denominator", true);
+}
+
+// ---------------------------------------------------------
+// RationalStore
+// ---------------------------------------------------------
+static void testStore()
+{
+    const std::string path = "IntegerTests_store.tmp";
+    std::vector<Rational> values = {Rational(), Rational(-7LL),
+                                     Rational(Integer(1), Integer(3))};
+    for (int i = 0; i < 300; ++i)
+        values.push_back(randomRational(rng() % 30, 1 + rng() % 8));
+    RationalStore::write(path, values);
+    {
+        RationalStore store(path);
+        check(store.size() == values.size(), "size");
+        bool same = true;
+        for (std::size_t i = 0; i < values.size(); ++i)
+            same = same && store[i] == values[i]
+                   && store.numerator(i) == IntegerView(values[i].numerator())
+                   && store.denominator(i) == IntegerView(values[i].denominator());
+        check(same, "values");
+        check(!throws<std::invalid_argument>([&store] { store.verify(); }), "verify");
+
+        for (std::size_t first : {std::size_t(0), std::size_t(1), std::size_t(100)})
+            for (std::size_t last : {first, first + 1, first + 57, values.size()})
+            {
+                std::string what = "[" + str(first) + ", " + str(last) + ")";
+                Rational sum, product(1LL);
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    sum += values[i];
+                    product *= values[i];
+                }
+                check(store.sum(first, last) == sum, "sum " + what);
+                check(store.product(first, last) == product, "product " + what);
+                if (first == last)
+                    continue;
+                auto begin = values.begin() + first, end = values.begin() + last;
+                check(store.min(first, last) == *std::min_element(begin, end),
+                      "min " + what);
+                check(store.max(first, last) == *std::max_element(begin, end),
+                      "max " + what);
+            }
+        check(store.sum() == store.sum(0, values.size()), "sum()");
+        check(throws<std::out_of_range>([&store] { store.sum(2, 1); }), "reversed range");
+        check(throws<std::out_of_range>([&store] { store.sum(0, store.size() + 1); }),
+              "range past the end");
+        check(throws<std::domain_error>([&store] { store.min(3, 3); }), "min of nothing");
+    }
+
+    RationalStore::Writer writer(path);
+    check(throws<std::invalid_argument>([&writer] {
+              writer.append(Rational::fromReduced(Integer(2), Integer(4)));
+          }),
+          "Writer rejects 2/4");
+    writer.close();
+
+    RationalStore::write(path, std::vector<Rational>());
+    {
+        RationalStore store(path);
+        check(store.size() == 0 && store.sum() == Rational()
+                  && store.product() == Rational(1LL),
+              "empty store");
+    }
+
+    // 1/3 with its numerator patched to 3, which only verify()
+    // looks for; then the file cut short.
+    RationalStore::write(path, std::vector<Rational>{Rational(Integer(1), Integer(3))});
+    std::FILE *f = std::fopen(path.c_str(), "r+b");
+    const unsigned char three = 3;
+    std::fseek(f, 32, SEEK_SET);  // header, count and the arena sizes
+    std::fwrite(&three, 1, 1, f);
+    std::fclose(f);
+    {
+        RationalStore store(path);
+        check(throws<std::invalid_argument>([&store] { store.verify(); }),
+              "verify rejects 3/3");
+    }
+    f = std::fopen(path.c_str(), "r+b");
+    std::fseek(f, 0, SEEK_END);
+    long size = std::ftell(f);
+    std::fclose(f);
+    std::vector<char> bytes(static_cast<std::size_t>(size));
+    f = std::fopen(path.c_str(), "rb");
+    std::size_t read = std::fread(bytes.data(), 1, bytes.size(), f);
+    std::fclose(f);
+    f = std::fopen(path.c_str(), "wb");
+    std::fwrite(bytes.data(), 1, read - 8, f);
+    std::fclose(f);
+    check(throws<std::invalid_argument>([&path] { RationalStore store(path); }),
+          "truncated store");
+    std::remove(path.c_str());
+    check(throws<std::runtime_error>([&path] { RationalStore store(path); }),
+          "missing store");
+}
+
+// ---------------------------------------------------------
+// Batches
+// Element-wise results against Integer and Rational.
+// ---------------------------------------------------------
+static long long randomWord()
+{
+    switch (rng() % 4)
+    {
+    case 0:
+        return static_cast<long long>(rng());
+    case 1:
+        return LLONG_MAX - static_cast<long long>(rng() % 3);
+    case 2:
+        return LLONG_MIN + static_cast<long long>(rng() % 3);
+    default:
+        return static_cast<long long>(rng() % 2001) - 1000;
+    }
+}
+
+static void testBatches()
+{
+    // An odd size leaves a tail after the vector lanes.
+    const std::size_t n = 1003;
+    std::vector<Integer> xs, ys;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        xs.push_back(rng() % 16 ? Integer(randomWord()) : randomInteger(2));
+        ys.push_back(rng() % 16 ? Integer(randomWord()) : randomInteger(2));
+    }
+    IntegerBatch a(xs), b(ys);
+    check(a.toVector() == xs, "IntegerBatch round trip");
+    bool words = true;
+    for (std::size_t i = 0; i < n; ++i)
+        words = words && a.isWord(i) == (xs[i].fitsLongLong() && xs[i] != Integer(LLONG_MIN));
+    check(words, "IntegerBatch word lanes");
+    IntegerBatch sum = a + b, difference = a - b, product = a * b;
+    std::vector<signed char> order = IntegerBatch::compare(a, b);
+    bool ok[4] = {true, true, true, true};
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        ok[0] = ok[0] && sum[i] == xs[i] + ys[i];
+        ok[1] = ok[1] && difference[i] == xs[i] - ys[i];
+        ok[2] = ok[2] && product[i] == xs[i] * ys[i];
+        ok[3] = ok[3] && order[i] == (xs[i] < ys[i] ? -1 : xs[i] > ys[i] ? 1 : 0);
+    }
+    check(ok[0], "IntegerBatch +");
+    check(ok[1], "IntegerBatch -");
+    check(ok[2], "IntegerBatch *");
+    check(ok[3], "IntegerBatch compare");
+    a.set(5, powerOfTwo(100));
+    a.set(6, Integer(-3));
+    check(a[5] == powerOfTwo(100) && a[6] == Integer(-3) && a.isWord(6),
+          "IntegerBatch set");
+    check(throws<std::invalid_argument>([&a] { a + IntegerBatch(3); }),
+          "IntegerBatch size mismatch");
+
+    std::vector<Rational> rs, ss;
+    auto randomFraction = [] {
+        if (rng() % 16 == 0)
+            return randomRational(2, 2);
+        long long d = randomWord();
+        return Rational(Integer(randomWord()), Integer(d == 0 ? 1 : d));
+    };
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        rs.push_back(randomFraction());
+        ss.push_back(randomFraction());
+    }
+    RationalBatch r(rs), s(ss);
+    check(r.toVector() == rs, "RationalBatch round trip");
+    RationalBatch rsum = r + s, rdifference = r - s, rproduct = r * s;
+    std::vector<signed char> rorder = RationalBatch::compare(r, s);
+    bool rok[4] = {true, true, true, true};
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        rok[0] = rok[0] && rsum[i] == rs[i] + ss[i];
+        rok[1] = rok[1] && rdifference[i] == rs[i] - ss[i];
+        rok[2] = rok[2] && rproduct[i] == rs[i] * ss[i];
+        rok[3] = rok[3] && rorder[i] == rs[i].compare(ss[i]);
+    }
+    check(rok[0], "RationalBatch +");
+    check(rok[1], "RationalBatch -");
+    check(rok[2], "RationalBatch *");
+    check(rok[3], "RationalBatch compare");
+    r.set(0, Rational(Integer(-2), Integer(6)));
+    check(r[0] == Rational(Integer(-1), Integer(3)) && r.isWord(0), "RationalBatch set");
+    check(throws<std::invalid_argument>([&r] { r * RationalBatch(2); }),
+          "RationalBatch size mismatch");
+}
+
+// ---------------------------------------------------------
+// Configurations
+// ---------------------------------------------------------
+struct Config
+{
+    const char *name;
+    Integer::MultiplyThresholds multiply;
+    Integer::DivideThresholds divide;
+    Integer::GcdThresholds gcd;
+};
+
+static std::vector<Config> configs()
+{
+    const std::size_t never = SIZE_MAX;
+    Config defaults{"default", {}, {}, {}};
+
+    Config schoolbook = defaults;
+    schoolbook.name = "schoolbook";
+    Integer::MultiplyThresholds &m = schoolbook.multiply;
+    m.karatsuba = m.toom3 = m.ntt = never;
+    m.squareKaratsuba = m.squareToom3 = m.squareNtt = never;
+    m.parallel = never;
+    schoolbook.divide.divideAndConquer = schoolbook.divide.newton = never;
+    schoolbook.gcd.halfGcd = never;
+
+    Config lowered = defaults;
+    lowered.name = "lowered";
+    Integer::MultiplyThresholds &l = lowered.multiply;
+    l.karatsuba = l.squareKaratsuba = 2;
+    l.toom3 = l.squareToom3 = 6;
+    l.ntt = l.squareNtt = never;
+    l.parallel = 16;
+    lowered.divide.divideAndConquer = 2;
+    lowered.divide.newton = never;
+    lowered.gcd.halfGcd = lowered.gcd.halfGcdBasecase = 8;
+
+    Config loweredNtt = lowered;
+    loweredNtt.name = "lowered-ntt";
+    loweredNtt.multiply.ntt = loweredNtt.multiply.squareNtt = 16;
+    loweredNtt.divide.newton = 8;
+
+    return {defaults, schoolbook, lowered, loweredNtt};
+}
+
+int main(int argc, char **argv)
+{
+    std::string filter;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strncmp(argv[i], "--filter=", 9) == 0)
+            filter = argv[i] + 9;
+        else
+        {
+            std::fprintf(stderr, "unknown option %s (see the header of "
+                                 "tests/IntegerTests.cpp)\n", argv[i]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    const struct
+    {
+        const char *name;
+        void (*run)();
+    } suites[] = {
+        {"conversion", testConversion}, {"addition", testAddition},
+        {"multiplication", testMultiplication}, {"division", testDivision},
+        {"gcd", testGcd}, {"power", testPower}, {"bitwise", testBitwise},
+        {"rational", testRational}, {"serialization", testSerialization},
+        {"store", testStore}, {"batches", testBatches}};
+
+    for (const Config &config : configs())
+    {
+        Integer::multiplyThresholds() = config.multiply;
+        Integer::divideThresholds() = config.divide;
+        Integer::gcdThresholds() = config.gcd;
+        // More than one thread even on a single core, so the
+        // parallel paths run.
+        Integer::multiplyThresholds().threads = 4;
+        for (const auto &suite : suites)
+        {
+            current = std::string(config.name) + "/" + suite.name;
+            if (current.find(filter) == std::string::npos)
+                continue;
+            unsigned long long before = failures;
+            auto start = std::chrono::steady_clock::now();
+            suite.run();
+            std::chrono::duration<double> seconds
+                = std::chrono::steady_clock::now() - start;
+            std::printf("%-32s %-6s %8.2f s\n", current.c_str(),
+                        failures == before ? "ok" : "FAILED", seconds.count());
+            std::fflush(stdout);
+        }
+    }
+
+    std::printf("%llu checks, %llu failed\n", checks, failures);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}